@@ -1,35 +1,275 @@
+#define _CRT_SECURE_NO_WARNINGS // for fopen
 #include <iostream> // for std::cout, std::cin
 #include <string> // for std::string, std::getline
+#include <string_view> // for std::string_view (C++17)
 #include <limits>
-#include <cctype> // for toupper
+#include <cstring> // for memcpy, memmove
+#include <cstdio> // for FILE, fopen, fwrite, std::rename, std::remove
+#include <fstream> // for std::ifstream
+#include <algorithm> // for std::sort
+#include <thread> // for std::thread
+#include <atomic> // for std::atomic
+#include <shared_mutex> // for std::shared_mutex, std::shared_lock (C++17)
+#include <mutex> // for std::unique_lock
+#include <chrono> // for std::chrono::steady_clock, used by the benchmark
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX // otherwise windows.h defines "min"/"max" macros, which break std::numeric_limits<...>::max()
+#include <windows.h> // for CreateFileMapping, MapViewOfFile
+#include <io.h> // for _commit, _fileno
+#else
+#include <unistd.h> // for fsync, close
+#include <fcntl.h> // for open
+#include <sys/mman.h> // for mmap, munmap
+#include <sys/stat.h> // for fstat
+#endif
+
+// SSE2 is guaranteed on x64 and is the default target for 32-bit MSVC builds (/arch:SSE2), so we can use it for the column scans
+// if a compiler doesn't advertise it, we just fall back to the plain loops
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#include <emmintrin.h> // for the SSE2 intrinsics (_mm_cmpeq_epi8, _mm_movemask_epi8, ...)
+#define HW6_USE_SSE2
+#endif
 
 enum class VehicleType { SEDAN, COUPE, HATCHBACK, MINIVAN, CONVERTIBLE, SUV, PICKUP, UNKNOWN }; // use the safer enum-class
 // it doesn't automatically convert to int and requires explicit usage via the enum identifier, avoiding accidents
 
-struct Pair { // helper pair for converting VehicleType to string and vice-versa
-    // we will create a list of such objects and use them to map strings to vehicle types
-    std::string first;
-    VehicleType second;
+typedef unsigned int StringHandle; // a 32-bit reference to a string stored in the StringPool; handle 0 is always the empty string
+
+class StringPool { // shared storage for makes and models, each distinct string is stored exactly once
+    // in a real fleet the same few makes/models ("Toyota", "Corolla") repeat massively, so instead of every vehicle
+    // carrying its own copies, vehicles keep 4-byte handles; equal strings always get the same handle,
+    // so comparing two makes is comparing two ints, and the handle itself can be used as a hash or as an array index
+    // strings are never removed and never moved, so a handle (and a view of its characters) stays valid forever
+    private:
+        struct Entry {
+            const char* text;
+            unsigned int length;
+            unsigned int hash;
+        };
+
+        // entries live in fixed-size pages which never move, so readers can look up a handle while another thread adds strings
+        static const int PAGE_BITS = 12;
+        static const int PAGE_SIZE = 1 << PAGE_BITS;
+        static const int MAX_PAGES = 1 << 14; // room for 64M distinct strings
+        static const int BLOCK_SIZE = 64 * 1024; // characters are copied into big blocks, instead of one allocation per string
+        static const StringHandle EMPTY_SLOT = 0xFFFFFFFFu;
+
+        std::atomic<Entry*>* pages = nullptr;
+        std::atomic<unsigned int> count;
+        char** blocks = nullptr; // every block we allocated, so the destructor can free them
+        int blockCount = 0;
+        int blockCapacity = 0;
+        char* currentBlock = nullptr; // the block small strings are currently copied into
+        int blockUsed = 0; // characters used in the current block
+        StringHandle* slots = nullptr; // open-addressing hash table of handles, for finding a string's handle
+        unsigned int slotCount = 0;
+        mutable std::shared_mutex lock; // lookups share it, adding a new string takes it exclusively
+
+        static unsigned int hashText(const std::string_view text) { // FNV-1a
+            unsigned int h = 2166136261u;
+            for (char c : text) {
+                h ^= (unsigned char)c;
+                h *= 16777619u;
+            }
+            return h;
+        }
+
+        const Entry& entry(const StringHandle handle) const {
+            // acquire pairs with the release in "intern", so the page's contents are visible before we read them
+            return this->pages[handle >> PAGE_BITS].load(std::memory_order_acquire)[handle & (PAGE_SIZE - 1)];
+        }
+
+        StringHandle findSlot(const std::string_view text, const unsigned int hash, unsigned int& pos) const { // caller holds the lock
+            pos = hash & (this->slotCount - 1);
+            while (this->slots[pos] != EMPTY_SLOT) {
+                const Entry& candidate = this->entry(this->slots[pos]);
+                if (candidate.hash == hash && std::string_view(candidate.text, candidate.length) == text) {
+                    return this->slots[pos];
+                }
+                pos = (pos + 1) & (this->slotCount - 1);
+            }
+            return EMPTY_SLOT;
+        }
+
+        char* allocateBlock(const int size) {
+            if (this->blockCount == this->blockCapacity) {
+                int newCapacity = this->blockCapacity ? this->blockCapacity * 2 : 16;
+                char** tmp = new char*[newCapacity];
+                if (this->blockCount > 0) {
+                    memcpy(tmp, this->blocks, sizeof(char*) * this->blockCount);
+                }
+                delete[] this->blocks;
+                this->blocks = tmp;
+                this->blockCapacity = newCapacity;
+            }
+            char* block = new char[size];
+            this->blocks[this->blockCount++] = block;
+            return block;
+        }
+
+        const char* storeText(const std::string_view text) { // copy the characters into the arena (caller holds the lock exclusively)
+            int length = (int)text.size();
+            if (length == 0) {
+                return "";
+            }
+            if (length > BLOCK_SIZE / 4) { // a long string gets a block of its own, so it doesn't waste the rest of the current one
+                char* block = this->allocateBlock(length);
+                memcpy(block, text.data(), length);
+                return block;
+            }
+            if (!this->currentBlock || this->blockUsed + length > BLOCK_SIZE) {
+                this->currentBlock = this->allocateBlock(BLOCK_SIZE);
+                this->blockUsed = 0;
+            }
+            char* destination = this->currentBlock + this->blockUsed;
+            memcpy(destination, text.data(), length);
+            this->blockUsed += length;
+            return destination;
+        }
+
+        void rehash(const unsigned int newSlotCount) { // caller holds the lock exclusively
+            delete[] this->slots;
+            this->slots = new StringHandle[newSlotCount];
+            this->slotCount = newSlotCount;
+            for (unsigned int i = 0; i < newSlotCount; i++) {
+                this->slots[i] = EMPTY_SLOT;
+            }
+            unsigned int total = this->count.load(std::memory_order_relaxed);
+            for (StringHandle handle = 0; handle < total; handle++) {
+                unsigned int pos = this->entry(handle).hash & (newSlotCount - 1);
+                while (this->slots[pos] != EMPTY_SLOT) {
+                    pos = (pos + 1) & (newSlotCount - 1);
+                }
+                this->slots[pos] = handle;
+            }
+        }
+
+        StringPool() : count(0) {
+            this->pages = new std::atomic<Entry*>[MAX_PAGES];
+            for (int i = 0; i < MAX_PAGES; i++) {
+                this->pages[i].store(nullptr, std::memory_order_relaxed);
+            }
+            this->rehash(1024);
+            this->intern(std::string_view()); // handle 0 = ""
+        }
+
+    public:
+        StringPool(const StringPool&) = delete;
+        StringPool& operator=(const StringPool&) = delete;
+
+        ~StringPool() {
+            for (int i = 0; i < MAX_PAGES; i++) {
+                delete[] this->pages[i].load(std::memory_order_relaxed);
+            }
+            delete[] this->pages;
+            for (int i = 0; i < this->blockCount; i++) {
+                delete[] this->blocks[i];
+            }
+            delete[] this->blocks;
+            delete[] this->slots;
+        }
+
+        static StringPool& instance() { // the one pool shared by every vehicle
+            // a static local is created the first time this runs (thread-safe since C++11) and destroyed when the program ends
+            static StringPool pool;
+            return pool;
+        }
+
+        StringHandle intern(const std::string_view text) { // returns the handle of a string, adding it if it's new
+            unsigned int hash = StringPool::hashText(text);
+            unsigned int pos;
+            {
+                std::shared_lock<std::shared_mutex> guard(this->lock); // most strings are already there, so try with a shared lock first
+                StringHandle found = this->findSlot(text, hash, pos);
+                if (found != EMPTY_SLOT) {
+                    return found;
+                }
+            }
+            std::unique_lock<std::shared_mutex> guard(this->lock);
+            StringHandle found = this->findSlot(text, hash, pos); // another thread might have added it in between
+            if (found != EMPTY_SLOT) {
+                return found;
+            }
+            StringHandle handle = this->count.load(std::memory_order_relaxed);
+            if ((handle >> PAGE_BITS) >= (unsigned int)MAX_PAGES) {
+                throw "String pool is full!";
+            }
+            Entry* page = this->pages[handle >> PAGE_BITS].load(std::memory_order_relaxed);
+            if (!page) {
+                page = new Entry[PAGE_SIZE];
+            }
+            page[handle & (PAGE_SIZE - 1)] = Entry{ this->storeText(text), (unsigned int)text.size(), hash };
+            this->pages[handle >> PAGE_BITS].store(page, std::memory_order_release); // publish the entry before anyone can get its handle
+            this->count.store(handle + 1, std::memory_order_release);
+            this->slots[pos] = handle;
+            if ((handle + 1) * 2 > this->slotCount) { // keep the table at most half full
+                this->rehash(this->slotCount * 2);
+            }
+            return handle;
+        }
+
+        bool find(const std::string_view text, StringHandle& handle) const { // looks a string up without adding it
+            unsigned int pos;
+            std::shared_lock<std::shared_mutex> guard(this->lock);
+            handle = this->findSlot(text, StringPool::hashText(text), pos);
+            return handle != EMPTY_SLOT;
+        }
+
+        std::string_view view(const StringHandle handle) const { // the characters of a handle, without copying them
+            const Entry& found = this->entry(handle);
+            return std::string_view(found.text, found.length);
+        }
+
+        unsigned int hash(const StringHandle handle) const { // hash of the string's contents (the same in every run of the program)
+            return this->entry(handle).hash;
+        }
+
+        unsigned int getCount() const {
+            return this->count.load(std::memory_order_acquire);
+        }
 };
 
 class Vehicle {
     private:
-        std::string make;
-        std::string model;
+        StringHandle make; // handles into the StringPool instead of our own std::strings (4 bytes each, instead of 32+)
+        StringHandle model;
         VehicleType vehicleType;
         int ID;
         int year;
-        static int idCounter;
-        static Pair changeMap[];
-        static int mapItems; // keeps the length of the enum
-        // not ideal solution, but until we learn some more advanced methods (such as reading from file and deducing the length from there), we go with hardcoding
+        static std::atomic<int> idCounter; // atomic, so threads creating vehicles at the same time still get unique IDs
+        // names of the vehicle types, indexed by the enum's value (so the order must match the enum)
+        // std::string_view is just a pointer + length to characters living elsewhere (here, string literals), so this table never allocates
+        // being constexpr, it is built entirely at compile time
+        static constexpr std::string_view typeNames[] = { "SEDAN", "COUPE", "HATCHBACK", "MINIVAN", "CONVERTIBLE", "SUV", "PICKUP", "UNKNOWN" };
+
+        static constexpr char toUpper(const char c) { // ASCII-only uppercase, unlike std::toupper this can run at compile time
+            return (c >= 'a' && c <= 'z') ? (char)(c - 'a' + 'A') : c;
+        }
+
+        static constexpr bool equalsIgnoreCase(const std::string_view text, const std::string_view upperName) {
+            if (text.size() != upperName.size()) {
+                return false;
+            }
+            for (size_t i = 0; i < text.size(); i++) {
+                if (Vehicle::toUpper(text[i]) != upperName[i]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        static constexpr VehicleType matchType(const std::string_view text, const VehicleType candidate) {
+            // the switch only narrowed it down to one candidate, so we still have to confirm the whole word
+            return Vehicle::equalsIgnoreCase(text, Vehicle::typeNames[(int)candidate]) ? candidate : VehicleType::UNKNOWN;
+        }
     public:
-        Vehicle() : make(""), model(""), vehicleType(VehicleType::UNKNOWN), ID(0), year(0) { }
+        Vehicle() : make(0), model(0), vehicleType(VehicleType::UNKNOWN), ID(0), year(0) { }
         // increment the ID only for properly constructed elements
         // use enum identifier to refer to elements of the enum ("VehicleType::")
 
         Vehicle(const std::string& make, const std::string& model, const VehicleType vehicleType, const int year) :
-            make(""), model(""), vehicleType(VehicleType::UNKNOWN), year(0), ID(idCounter++) { // we give default values here and use setters to validate
+            make(0), model(0), vehicleType(VehicleType::UNKNOWN), year(0), ID(idCounter++) { // we give default values here and use setters to validate
             // if the validation fails, we get to keep the default values and have a correct object
             // use const + "&" for complex params such that no copy for them is made and we are not able to modify them inside of our function
             // for small/trivial params, there's no need to use that combo (or any of the elements of it) - since by not using "&" a copy is made, and we can modify it however we want
@@ -40,113 +280,1228 @@ class Vehicle {
             this->setYear(year);
         }
 
-        // no destructor since no dynamic fields
-
-        // for these simple values, ideally we'd return them as const, but it doesn't make any sense, so we leave them just as they are
-        std::string getMake() const { // we wouldn't want to use const + "&" here, since somebody could then cast away the const and modify our internal buffers
-            // so we just return a copy of the string
-            return this->make;
+        Vehicle(const int ID, const std::string& make, const std::string& model, const VehicleType vehicleType, const int year) :
+            make(0), model(0), vehicleType(VehicleType::UNKNOWN), ID(ID), year(0) { // used when restoring a saved vehicle, which already has its ID
+            this->setMake(make);
+            this->setModel(model);
+            this->setVehicleType(vehicleType);
+            this->setYear(year);
+            Vehicle::setNextID(ID + 1); // make sure new vehicles never get an ID which is already taken
+        }
+
+        // no destructor since no dynamic fields (the strings belong to the pool)
+
+        // for these simple values, ideally we'd return them as const, but it doesn't make any sense, so we leave them just as they are
+        std::string_view getMake() const { // a read-only view into the pool, so nothing gets copied
+            // the pool never changes or frees a string once it's added, so the view stays valid, and it can't be used to modify anything
+            return StringPool::instance().view(this->make);
+        }
+
+        std::string_view getModel() const {
+            return StringPool::instance().view(this->model);
+        }
+
+        StringHandle getMakeHandle() const { // equal makes always have equal handles, so comparing these is just an int compare
+            return this->make;
+        }
+
+        StringHandle getModelHandle() const {
+            return this->model;
+        }
+
+        VehicleType getVehicleType() const {
+            return this->vehicleType;
+        }
+
+        int getYear() const {
+            return this->year;
+        }
+
+        int getID() const {
+            return this->ID;
+        }
+
+        static int getNextID() {
+            return Vehicle::idCounter.load();
+        }
+
+        static void setNextID(const int nextID) { // only used when restoring the garage from disk
+            int current = Vehicle::idCounter.load();
+            // only ever move the counter forward; if another thread changed it meanwhile, compare_exchange reloads "current" and we retry
+            while (nextID > current && !Vehicle::idCounter.compare_exchange_weak(current, nextID)) {
+            }
+        }
+
+        void setMake(const std::string_view make) {
+            if (!make.empty()) {
+                this->make = StringPool::instance().intern(make); // only stores the characters if the pool hasn't seen them yet
+            }
+            else {
+                std::cout << std::endl << "Make cannot be empty!" << std::endl;
+                // leave it unchanged if fail
+            }
+        }
+
+        void setModel(const std::string_view model) {
+            if (!model.empty()) {
+                this->model = StringPool::instance().intern(model);
+            }
+            else {
+                std::cout << std::endl << "Model cannot be empty!" << std::endl;
+            }
+        }
+
+        void setVehicleType(const VehicleType vehicleType) {
+            this->vehicleType = vehicleType;
+        }
+
+        void setYear(int year) {
+            if (year > -1 && year < 2026) {
+                this->year = year;
+            }
+            else {
+                std::cout << std::endl << "Year cannot be negative or bigger than the current year!" << std::endl;
+            }
+        }
+
+        static constexpr VehicleType stringToVehicleType(const std::string_view vehicleTypeStr) {
+            // instead of uppercasing a copy and comparing it against every name, we use the length and the first letter
+            // to jump straight to the only type it could be, and then compare that one name ignoring case
+            // users can still type in whatever case they want, and nothing gets allocated
+            if (vehicleTypeStr.empty()) {
+                return VehicleType::UNKNOWN;
+            }
+            const char first = Vehicle::toUpper(vehicleTypeStr[0]);
+            switch (vehicleTypeStr.size()) {
+                case 3:
+                    return Vehicle::matchType(vehicleTypeStr, VehicleType::SUV);
+                case 5: // SEDAN and COUPE share the length, the first letter tells them apart
+                    if (first == 'S') {
+                        return Vehicle::matchType(vehicleTypeStr, VehicleType::SEDAN);
+                    }
+                    return Vehicle::matchType(vehicleTypeStr, VehicleType::COUPE);
+                case 6:
+                    return Vehicle::matchType(vehicleTypeStr, VehicleType::PICKUP);
+                case 7: // same for MINIVAN and UNKNOWN
+                    if (first == 'M') {
+                        return Vehicle::matchType(vehicleTypeStr, VehicleType::MINIVAN);
+                    }
+                    return VehicleType::UNKNOWN; // either "UNKNOWN" itself, or no match at all
+                case 9:
+                    return Vehicle::matchType(vehicleTypeStr, VehicleType::HATCHBACK);
+                case 11:
+                    return Vehicle::matchType(vehicleTypeStr, VehicleType::CONVERTIBLE);
+                default:
+                    return VehicleType::UNKNOWN; // no type has this length
+            }
+        }
+
+        static constexpr std::string_view vehicleTypeToString(const VehicleType vehicleType) {
+            const int index = (int)vehicleType;
+            if (index < 0 || index > (int)VehicleType::UNKNOWN) {
+                return "UNKNOWN"; // guard against values which were cast into the enum from outside its range
+            }
+            return Vehicle::typeNames[index];
+        }
+};
+
+std::atomic<int> Vehicle::idCounter(1); // 1-index
+// since both conversions are constexpr, the compiler can check them for us while compiling
+static_assert(Vehicle::stringToVehicleType("suv") == VehicleType::SUV, "type parsing is broken");
+static_assert(Vehicle::stringToVehicleType("Convertible") == VehicleType::CONVERTIBLE, "type parsing is broken");
+static_assert(Vehicle::stringToVehicleType("sedans") == VehicleType::UNKNOWN, "type parsing is broken");
+static_assert(Vehicle::vehicleTypeToString(VehicleType::PICKUP) == "PICKUP", "type names are broken");
+
+class VehicleColumns { // structure-of-arrays copy of the garage, used only for scans
+    // instead of one array of Vehicle objects, we keep one array per attribute
+    // a scan such as "all SUVs from 2015-2020" then only walks the "types" and "years" arrays, which are small and contiguous
+    // row "i" of every column belongs to the same vehicle, and it is kept in the same order as the Garage's vehicles array
+    private:
+        int* ids = nullptr;
+        int* years = nullptr;
+        unsigned char* types = nullptr; // a VehicleType fits in one byte, so 16 of them fit in one SSE2 register
+        StringHandle* makeCodes = nullptr; // the make/model are already dictionary-encoded by the StringPool, so we just keep the handles
+        StringHandle* modelCodes = nullptr;
+        int size = 0;
+        int capacity = 0;
+
+        void resize(int newCapacity = 0) {
+            if (newCapacity <= this->capacity) {
+                newCapacity = this->capacity ? this->capacity * 2 : 128; // grow geometrically, so appending stays cheap for big garages
+            }
+            int* newIds = new int[newCapacity];
+            int* newYears = new int[newCapacity];
+            unsigned char* newTypes = new unsigned char[newCapacity];
+            StringHandle* newMakeCodes = new StringHandle[newCapacity];
+            StringHandle* newModelCodes = new StringHandle[newCapacity];
+            // unlike the Vehicle array, these are all trivial types, so memcpy is safe here
+            if (this->size > 0) {
+                memcpy(newIds, this->ids, sizeof(int) * this->size);
+                memcpy(newYears, this->years, sizeof(int) * this->size);
+                memcpy(newTypes, this->types, sizeof(unsigned char) * this->size);
+                memcpy(newMakeCodes, this->makeCodes, sizeof(StringHandle) * this->size);
+                memcpy(newModelCodes, this->modelCodes, sizeof(StringHandle) * this->size);
+            }
+            this->release();
+            this->ids = newIds;
+            this->years = newYears;
+            this->types = newTypes;
+            this->makeCodes = newMakeCodes;
+            this->modelCodes = newModelCodes;
+            this->capacity = newCapacity;
+        }
+
+        void release() {
+            delete[] this->ids;
+            delete[] this->years;
+            delete[] this->types;
+            delete[] this->makeCodes;
+            delete[] this->modelCodes;
+            this->ids = this->years = nullptr;
+            this->makeCodes = this->modelCodes = nullptr;
+            this->types = nullptr;
+        }
+
+        static void appendID(int*& result, int& count, int& resultCapacity, const int ID) { // helper for growing a result list
+            if (count == resultCapacity) {
+                resultCapacity = resultCapacity ? resultCapacity * 2 : 16;
+                int* tmp = new int[resultCapacity];
+                if (count > 0) {
+                    memcpy(tmp, result, sizeof(int) * count);
+                }
+                delete[] result;
+                result = tmp;
+            }
+            result[count++] = ID;
+        }
+
+        int* scan(const bool filterType, const VehicleType vehicleType, int minYear, int maxYear, int& count) const {
+            count = 0;
+            int resultCapacity = 0;
+            int* result = nullptr;
+            // valid years are in [0, 2025] (see Vehicle::setYear), so clamping keeps "minYear - 1" and "maxYear + 1" from overflowing
+            if (minYear < 0) {
+                minYear = 0;
+            }
+            if (maxYear > 2025) {
+                maxYear = 2025;
+            }
+            if (minYear > maxYear) {
+                return nullptr;
+            }
+            const unsigned char type = (unsigned char)vehicleType;
+            int i = 0;
+#ifdef HW6_USE_SSE2
+            // process 16 rows at a time: one compare on 16 type bytes, and four compares on 4 years each
+            // the four year masks are packed down to 16 bytes, so that both masks line up row by row
+            const __m128i typeKey = _mm_set1_epi8((char)type);
+            const __m128i below = _mm_set1_epi32(minYear - 1);
+            const __m128i above = _mm_set1_epi32(maxYear + 1);
+            for (; i + 16 <= this->size; i += 16) {
+                __m128i yearMasks[4];
+                for (int k = 0; k < 4; k++) {
+                    __m128i year = _mm_loadu_si128((const __m128i*)(this->years + i + 4 * k));
+                    yearMasks[k] = _mm_and_si128(_mm_cmpgt_epi32(year, below), _mm_cmplt_epi32(year, above));
+                }
+                // each mask lane is either 0 or -1, so the saturating packs keep them as 0 / -1 bytes
+                __m128i mask = _mm_packs_epi16(_mm_packs_epi32(yearMasks[0], yearMasks[1]), _mm_packs_epi32(yearMasks[2], yearMasks[3]));
+                if (filterType) {
+                    __m128i typeBlock = _mm_loadu_si128((const __m128i*)(this->types + i));
+                    mask = _mm_and_si128(mask, _mm_cmpeq_epi8(typeBlock, typeKey));
+                }
+                int bits = _mm_movemask_epi8(mask); // one bit per row
+                while (bits) {
+                    int row = 0;
+                    while (!(bits & (1 << row))) {
+                        row++;
+                    }
+                    bits &= bits - 1; // clear the lowest set bit
+                    VehicleColumns::appendID(result, count, resultCapacity, this->ids[i + row]);
+                }
+            }
+#endif
+            for (; i < this->size; i++) { // the leftover rows (or every row, without SSE2)
+                // "&" instead of "&&" keeps the loop free of branches on each individual condition
+                bool match = (this->years[i] >= minYear) & (this->years[i] <= maxYear) & (!filterType | (this->types[i] == type));
+                if (match) {
+                    VehicleColumns::appendID(result, count, resultCapacity, this->ids[i]);
+                }
+            }
+            return result;
+        }
+
+        static int* scanCodes(const StringHandle* codes, const int* ids, const int size, const std::string_view text, int& count) { // helper for make/model scans
+            count = 0;
+            int resultCapacity = 0;
+            int* result = nullptr;
+            StringHandle code;
+            if (!StringPool::instance().find(text, code)) { // the pool has never seen this string, so nothing can match
+                return nullptr;
+            }
+            for (int i = 0; i < size; i++) { // integer compares only, no string compares
+                if (codes[i] == code) {
+                    VehicleColumns::appendID(result, count, resultCapacity, ids[i]);
+                }
+            }
+            return result;
+        }
+
+    public:
+        VehicleColumns() = default;
+        VehicleColumns(const VehicleColumns&) = delete;
+        VehicleColumns& operator=(const VehicleColumns&) = delete;
+
+        ~VehicleColumns() {
+            this->release();
+        }
+
+        void reserve(const int newCapacity) {
+            if (newCapacity > this->capacity) {
+                this->resize(newCapacity);
+            }
+        }
+
+        void append(const Vehicle& vehicle) {
+            if (this->size == this->capacity) {
+                this->resize();
+            }
+            this->ids[this->size] = vehicle.getID();
+            this->set(this->size, vehicle);
+            this->size++;
+        }
+
+        void set(const int index, const Vehicle& vehicle) { // overwrite row "index" with the current state of a vehicle
+            this->years[index] = vehicle.getYear();
+            this->types[index] = (unsigned char)vehicle.getVehicleType();
+            this->makeCodes[index] = vehicle.getMakeHandle();
+            this->modelCodes[index] = vehicle.getModelHandle();
+        }
+
+        void insert(const int index, const Vehicle& vehicle) { // add a row in the middle, shifting the following rows to the right
+            if (this->size == this->capacity) {
+                this->resize();
+            }
+            int moved = this->size - index;
+            memmove(this->ids + index + 1, this->ids + index, sizeof(int) * moved);
+            memmove(this->years + index + 1, this->years + index, sizeof(int) * moved);
+            memmove(this->types + index + 1, this->types + index, sizeof(unsigned char) * moved);
+            memmove(this->makeCodes + index + 1, this->makeCodes + index, sizeof(StringHandle) * moved);
+            memmove(this->modelCodes + index + 1, this->modelCodes + index, sizeof(StringHandle) * moved);
+            this->ids[index] = vehicle.getID();
+            this->set(index, vehicle);
+            this->size++;
+        }
+
+        void remove(const int index) { // same shifting as the Garage does, so rows stay aligned with its vehicles array
+            int moved = this->size - index - 1;
+            if (moved > 0) {
+                // memmove rather than memcpy, since the source and destination overlap
+                memmove(this->ids + index, this->ids + index + 1, sizeof(int) * moved);
+                memmove(this->years + index, this->years + index + 1, sizeof(int) * moved);
+                memmove(this->types + index, this->types + index + 1, sizeof(unsigned char) * moved);
+                memmove(this->makeCodes + index, this->makeCodes + index + 1, sizeof(StringHandle) * moved);
+                memmove(this->modelCodes + index, this->modelCodes + index + 1, sizeof(StringHandle) * moved);
+            }
+            this->size--;
+        }
+
+        // all queries return a dynamic array of IDs (in garage order), or nullptr if nothing matched
+        // beware: the caller has the responsibility of cleaning it up
+        int* selectByTypeAndYear(const VehicleType vehicleType, const int minYear, const int maxYear, int& count) const {
+            return this->scan(true, vehicleType, minYear, maxYear, count);
+        }
+
+        int* selectByYear(const int minYear, const int maxYear, int& count) const {
+            return this->scan(false, VehicleType::UNKNOWN, minYear, maxYear, count);
+        }
+
+        int* selectByMake(const std::string_view make, int& count) const {
+            return VehicleColumns::scanCodes(this->makeCodes, this->ids, this->size, make, count);
+        }
+
+        int* selectByModel(const std::string_view model, int& count) const {
+            return VehicleColumns::scanCodes(this->modelCodes, this->ids, this->size, model, count);
+        }
+};
+
+class IdList { // sorted list of vehicle IDs, the building block of every secondary index
+    private:
+        int* ids = nullptr;
+        int size = 0;
+        int capacity = 0;
+
+        int lowerBound(const int ID) const { // position of the first ID >= the given one
+            int left = 0;
+            int right = this->size;
+            while (left < right) {
+                int middle = left + (right - left) / 2;
+                if (this->ids[middle] < ID) {
+                    left = middle + 1;
+                }
+                else {
+                    right = middle;
+                }
+            }
+            return left;
+        }
+
+    public:
+        IdList() = default;
+        IdList(const IdList&) = delete;
+        IdList& operator=(const IdList&) = delete;
+
+        ~IdList() {
+            delete[] this->ids;
+            this->ids = nullptr;
+        }
+
+        void swap(IdList& other) { // exchange contents without copying, used when an array of lists has to grow
+            int* tmpIds = this->ids;
+            int tmpSize = this->size;
+            int tmpCapacity = this->capacity;
+            this->ids = other.ids;
+            this->size = other.size;
+            this->capacity = other.capacity;
+            other.ids = tmpIds;
+            other.size = tmpSize;
+            other.capacity = tmpCapacity;
+        }
+
+        void insert(const int ID) {
+            if (this->size == this->capacity) {
+                int newCapacity = this->capacity ? this->capacity * 2 : 4;
+                int* tmp = new int[newCapacity];
+                if (this->size > 0) {
+                    memcpy(tmp, this->ids, sizeof(int) * this->size);
+                }
+                delete[] this->ids;
+                this->ids = tmp;
+                this->capacity = newCapacity;
+            }
+            // new vehicles always get the biggest ID so far, so in practice this is an append
+            int pos = (this->size == 0 || this->ids[this->size - 1] < ID) ? this->size : this->lowerBound(ID);
+            memmove(this->ids + pos + 1, this->ids + pos, sizeof(int) * (this->size - pos));
+            this->ids[pos] = ID;
+            this->size++;
+        }
+
+        void remove(const int ID) {
+            int pos = this->lowerBound(ID);
+            if (pos < this->size && this->ids[pos] == ID) {
+                memmove(this->ids + pos, this->ids + pos + 1, sizeof(int) * (this->size - pos - 1));
+                this->size--;
+            }
+        }
+
+        bool contains(const int ID) const {
+            int pos = this->lowerBound(ID);
+            return pos < this->size && this->ids[pos] == ID;
+        }
+
+        int getSize() const {
+            return this->size;
+        }
+
+        const int* getIDs() const {
+            return this->ids;
+        }
+};
+
+class HandleIdIndex { // hash index: string -> sorted list of IDs having that string
+    // pool handles are small consecutive numbers, so they can index the array of lists directly (a perfect hash for free)
+    private:
+        IdList* lists = nullptr;
+        int listCount = 0;
+
+    public:
+        HandleIdIndex() = default;
+        HandleIdIndex(const HandleIdIndex&) = delete;
+        HandleIdIndex& operator=(const HandleIdIndex&) = delete;
+
+        ~HandleIdIndex() {
+            delete[] this->lists;
+            this->lists = nullptr;
+        }
+
+        void insert(const StringHandle key, const int ID) {
+            if (key >= (StringHandle)this->listCount) {
+                int newCount = this->listCount ? this->listCount * 2 : 16;
+                while ((StringHandle)newCount <= key) {
+                    newCount *= 2;
+                }
+                IdList* tmp = new IdList[newCount];
+                for (int i = 0; i < this->listCount; i++) {
+                    tmp[i].swap(this->lists[i]); // lists can't be copied, so we swap them into the new array
+                }
+                delete[] this->lists;
+                this->lists = tmp;
+                this->listCount = newCount;
+            }
+            this->lists[key].insert(ID);
+        }
+
+        void remove(const StringHandle key, const int ID) {
+            if (key < (StringHandle)this->listCount) {
+                this->lists[key].remove(ID);
+            }
+        }
+
+        const IdList* find(const std::string_view text) const { // nullptr if no vehicle ever had this string
+            StringHandle key;
+            if (!StringPool::instance().find(text, key) || key >= (StringHandle)this->listCount) {
+                return nullptr;
+            }
+            return &this->lists[key];
+        }
+};
+
+struct VehicleQuery { // filters for Garage::query; leave a field at its default to not filter on it
+    std::string make; // empty = any make
+    std::string model; // empty = any model
+    std::string vehicleType; // empty = any type
+    int minYear = 0;
+    int maxYear = 2025;
+};
+
+class VehicleIndexes { // secondary indexes over the garage, maintained on every add/update/delete
+    private:
+        static const int YEAR_COUNT = 2026; // valid years are in [0, 2025] (see Vehicle::setYear)
+        static const int TYPE_COUNT = (int)VehicleType::UNKNOWN + 1;
+
+        HandleIdIndex makes;
+        HandleIdIndex models;
+        IdList types[TYPE_COUNT]; // one bucket per vehicle type
+        IdList* years = nullptr; // one bucket per year (a counting-sort of the garage by year), so a range is just buckets [minYear, maxYear]
+
+    public:
+        VehicleIndexes() {
+            this->years = new IdList[VehicleIndexes::YEAR_COUNT];
+        }
+
+        VehicleIndexes(const VehicleIndexes&) = delete;
+        VehicleIndexes& operator=(const VehicleIndexes&) = delete;
+
+        ~VehicleIndexes() {
+            delete[] this->years;
+            this->years = nullptr;
+        }
+
+        void add(const Vehicle& vehicle) {
+            this->makes.insert(vehicle.getMakeHandle(), vehicle.getID());
+            this->models.insert(vehicle.getModelHandle(), vehicle.getID());
+            this->types[(int)vehicle.getVehicleType()].insert(vehicle.getID());
+            this->years[vehicle.getYear()].insert(vehicle.getID());
+        }
+
+        void remove(const Vehicle& vehicle) { // needs the vehicle as it was indexed, i.e. before any setter changed it
+            this->makes.remove(vehicle.getMakeHandle(), vehicle.getID());
+            this->models.remove(vehicle.getModelHandle(), vehicle.getID());
+            this->types[(int)vehicle.getVehicleType()].remove(vehicle.getID());
+            this->years[vehicle.getYear()].remove(vehicle.getID());
+        }
+
+        const IdList* findMake(const std::string_view make) const { // nullptr if no vehicle ever had this make
+            return this->makes.find(make);
+        }
+
+        const IdList* findModel(const std::string_view model) const {
+            return this->models.find(model);
+        }
+
+        const IdList& findType(const VehicleType vehicleType) const {
+            return this->types[(int)vehicleType];
+        }
+
+        const IdList& findYear(const int year) const { // year must be in [0, 2025]
+            return this->years[year];
+        }
+};
+
+class MappedFile { // read-only memory mapping of a whole file
+    // the OS maps the file into our address space and pages it in as we touch it, so even a multi-gigabyte dump
+    // is never copied into a buffer of ours, and every thread can parse its own part of it straight from memory
+    private:
+        const char* data = nullptr;
+        long long size = 0;
+#ifdef _WIN32
+        HANDLE file = INVALID_HANDLE_VALUE;
+        HANDLE mapping = nullptr;
+#else
+        int descriptor = -1;
+#endif
+
+    public:
+        MappedFile() = default;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        ~MappedFile() {
+            this->close();
+        }
+
+        bool open(const std::string& path) {
+            this->close();
+#ifdef _WIN32
+            this->file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (this->file == INVALID_HANDLE_VALUE) {
+                return false;
+            }
+            LARGE_INTEGER fileSize;
+            if (!GetFileSizeEx(this->file, &fileSize)) {
+                return false;
+            }
+            this->size = fileSize.QuadPart;
+            if (this->size == 0) { // an empty file cannot be mapped, but it is still a valid (empty) file
+                return true;
+            }
+            this->mapping = CreateFileMappingA(this->file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!this->mapping) {
+                return false;
+            }
+            this->data = (const char*)MapViewOfFile(this->mapping, FILE_MAP_READ, 0, 0, 0);
+            return this->data != nullptr;
+#else
+            this->descriptor = ::open(path.c_str(), O_RDONLY);
+            if (this->descriptor < 0) {
+                return false;
+            }
+            struct stat info;
+            if (fstat(this->descriptor, &info) != 0) {
+                return false;
+            }
+            this->size = info.st_size;
+            if (this->size == 0) {
+                return true;
+            }
+            void* view = mmap(nullptr, (size_t)this->size, PROT_READ, MAP_PRIVATE, this->descriptor, 0);
+            if (view == MAP_FAILED) {
+                return false;
+            }
+            madvise(view, (size_t)this->size, MADV_SEQUENTIAL); // only a hint, so the OS reads ahead more aggressively
+            this->data = (const char*)view;
+            return true;
+#endif
+        }
+
+        void close() {
+#ifdef _WIN32
+            if (this->data) {
+                UnmapViewOfFile(this->data);
+            }
+            if (this->mapping) {
+                CloseHandle(this->mapping);
+            }
+            if (this->file != INVALID_HANDLE_VALUE) {
+                CloseHandle(this->file);
+            }
+            this->mapping = nullptr;
+            this->file = INVALID_HANDLE_VALUE;
+#else
+            if (this->data) {
+                munmap((void*)this->data, (size_t)this->size);
+            }
+            if (this->descriptor >= 0) {
+                ::close(this->descriptor);
+            }
+            this->descriptor = -1;
+#endif
+            this->data = nullptr;
+            this->size = 0;
+        }
+
+        const char* getData() const {
+            return this->data;
+        }
+
+        long long getSize() const {
+            return this->size;
+        }
+};
+
+struct VehicleRecord { // one parsed line of a CSV file, not yet a Vehicle (so it doesn't take an ID)
+    std::string make;
+    std::string model;
+    VehicleType vehicleType = VehicleType::UNKNOWN;
+    int year = 0;
+};
+
+class VehicleCsvChunk { // the records parsed from one part of a CSV file, filled in by a single thread
+    private:
+        VehicleRecord* records = nullptr;
+        int count = 0;
+        int capacity = 0;
+        int rejected = 0; // lines which could not be turned into a valid vehicle
+
+        static std::string_view trim(std::string_view field) {
+            while (!field.empty() && (field.front() == ' ' || field.front() == '\r')) {
+                field.remove_prefix(1);
+            }
+            while (!field.empty() && (field.back() == ' ' || field.back() == '\r')) {
+                field.remove_suffix(1);
+            }
+            return field;
+        }
+
+        // reads the field starting at "pos" and moves "pos" past its delimiter; "quoted" fields may contain the delimiter
+        // a quote inside a quoted field is written twice (""), so we need a scratch string to un-escape it
+        static std::string_view nextField(const std::string_view line, size_t& pos, const char delimiter, std::string& scratch) {
+            if (pos > line.size()) { // the line ran out of fields; moving "pos" further lets the caller notice
+                pos = line.size() + 2;
+                return std::string_view();
+            }
+            size_t start = pos;
+            while (start < line.size() && line[start] == ' ') {
+                start++;
+            }
+            if (start < line.size() && line[start] == '"') {
+                scratch.clear();
+                size_t i = start + 1;
+                while (i < line.size()) {
+                    if (line[i] == '"') {
+                        if (i + 1 < line.size() && line[i + 1] == '"') {
+                            scratch += '"';
+                            i += 2;
+                            continue;
+                        }
+                        break; // closing quote
+                    }
+                    scratch += line[i++];
+                }
+                size_t end = line.find(delimiter, i);
+                pos = end == std::string_view::npos ? line.size() + 1 : end + 1;
+                return std::string_view(scratch);
+            }
+            size_t end = line.find(delimiter, pos);
+            if (end == std::string_view::npos) {
+                end = line.size();
+            }
+            std::string_view field = line.substr(pos, end - pos);
+            pos = end + 1;
+            return VehicleCsvChunk::trim(field);
+        }
+
+        static bool parseYear(const std::string_view text, int& year) {
+            if (text.empty() || text.size() > 4) {
+                return false;
+            }
+            year = 0;
+            for (char c : text) {
+                if (c < '0' || c > '9') {
+                    return false;
+                }
+                year = year * 10 + (c - '0');
+            }
+            return year < 2026; // same rule as Vehicle::setYear
+        }
+
+        void append(const std::string_view make, const std::string_view model, const VehicleType vehicleType, const int year) {
+            if (this->count == this->capacity) {
+                int newCapacity = this->capacity ? this->capacity * 2 : 1024;
+                VehicleRecord* tmp = new VehicleRecord[newCapacity];
+                for (int i = 0; i < this->count; i++) {
+                    tmp[i].make.swap(this->records[i].make); // swapping the strings avoids copying their characters
+                    tmp[i].model.swap(this->records[i].model);
+                    tmp[i].vehicleType = this->records[i].vehicleType;
+                    tmp[i].year = this->records[i].year;
+                }
+                delete[] this->records;
+                this->records = tmp;
+                this->capacity = newCapacity;
+            }
+            VehicleRecord& record = this->records[this->count++];
+            record.make.assign(make.data(), make.size());
+            record.model.assign(model.data(), model.size());
+            record.vehicleType = vehicleType;
+            record.year = year;
+        }
+
+    public:
+        VehicleCsvChunk() = default;
+        VehicleCsvChunk(const VehicleCsvChunk&) = delete;
+        VehicleCsvChunk& operator=(const VehicleCsvChunk&) = delete;
+
+        ~VehicleCsvChunk() {
+            delete[] this->records;
+            this->records = nullptr;
+        }
+
+        // a quoted field may contain newlines, so a record doesn't always end at the next '\n'
+        // every '"' switches between inside and outside of quotes (an escaped "" switches twice, so it changes nothing)
+        static bool insideQuotes(const char* begin, const char* end) { // whether [begin, end) leaves us inside quotes
+            bool quoted = false;
+            const char* quote = (const char*)memchr(begin, '"', end - begin);
+            while (quote) {
+                quoted = !quoted;
+                quote = (const char*)memchr(quote + 1, '"', end - quote - 1);
+            }
+            return quoted;
+        }
+
+        // the '\n' which ends the record going on at "from" ("quoted" tells whether "from" is inside quotes), or end if there's none
+        static const char* recordEnd(const char* from, const char* end, bool quoted) {
+            if (!quoted) { // the usual case: no quotes before the next newline, so memchr finds it as fast as before
+                const char* newline = (const char*)memchr(from, '\n', end - from);
+                if (!newline) {
+                    newline = end;
+                }
+                const char* quote = (const char*)memchr(from, '"', newline - from);
+                if (!quote) {
+                    return newline;
+                }
+                from = quote;
+            }
+            for (const char* p = from; p < end; p++) {
+                if (*p == '"') {
+                    quoted = !quoted;
+                }
+                else if (*p == '\n' && !quoted) {
+                    return p;
+                }
+            }
+            return end;
+        }
+
+        // parses every record in [begin, end) with the "make,model,type,year" layout
+        // invalid records (missing or extra fields, bad values) are skipped and counted, instead of printing an error for each of them
+        void parse(const char* begin, const char* end, const char delimiter) {
+            std::string makeScratch, modelScratch, typeScratch, yearScratch;
+            const char* lineStart = begin;
+            while (lineStart < end) {
+                const char* lineEnd = VehicleCsvChunk::recordEnd(lineStart, end, false);
+                std::string_view line(lineStart, lineEnd - lineStart);
+                lineStart = lineEnd + 1;
+                if (VehicleCsvChunk::trim(line).empty()) { // blank lines are not errors
+                    continue;
+                }
+                size_t pos = 0;
+                std::string_view make = VehicleCsvChunk::nextField(line, pos, delimiter, makeScratch);
+                std::string_view model = VehicleCsvChunk::nextField(line, pos, delimiter, modelScratch);
+                std::string_view type = VehicleCsvChunk::nextField(line, pos, delimiter, typeScratch);
+                std::string_view yearText = VehicleCsvChunk::nextField(line, pos, delimiter, yearScratch);
+                int year;
+                // the year has to be the last field: reading it moves "pos" just past the end of the line
+                if (pos != line.size() + 1 || make.empty() || model.empty() || !VehicleCsvChunk::parseYear(yearText, year)) {
+                    this->rejected++;
+                    continue;
+                }
+                this->append(make, model, Vehicle::stringToVehicleType(type), year);
+            }
+        }
+
+        int getCount() const {
+            return this->count;
+        }
+
+        int getRejected() const {
+            return this->rejected;
+        }
+
+        const VehicleRecord& getRecord(const int index) const {
+            return this->records[index];
+        }
+};
+
+class BufferedWriter { // writes through a big buffer, so a huge export does a few large writes instead of millions of small ones
+    private:
+        FILE* file = nullptr;
+        char* buffer = nullptr;
+        int size = 0;
+        int capacity;
+        bool failed = false;
+
+    public:
+        BufferedWriter(const std::string& path, const int capacity = 1 << 20) : capacity(capacity) {
+            this->file = fopen(path.c_str(), "wb");
+            this->buffer = new char[capacity];
+            this->failed = this->file == nullptr;
+        }
+
+        BufferedWriter(const BufferedWriter&) = delete;
+        BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+        ~BufferedWriter() {
+            this->close();
+            delete[] this->buffer;
+            this->buffer = nullptr;
+        }
+
+        void flush() {
+            if (this->size > 0 && this->file && !this->failed) {
+                this->failed = fwrite(this->buffer, 1, this->size, this->file) != (size_t)this->size;
+            }
+            this->size = 0;
+        }
+
+        bool close() { // returns whether everything was written successfully
+            this->flush();
+            if (this->file) {
+                this->failed = (fclose(this->file) != 0) || this->failed;
+                this->file = nullptr;
+            }
+            return !this->failed;
+        }
+
+        void write(const char* data, int length) {
+            if (length > this->capacity - this->size) {
+                this->flush();
+                if (length > this->capacity) { // too big for the buffer anyway, write it directly
+                    this->failed = this->failed || !this->file || fwrite(data, 1, length, this->file) != (size_t)length;
+                    return;
+                }
+            }
+            memcpy(this->buffer + this->size, data, length);
+            this->size += length;
+        }
+
+        void write(const std::string_view text) {
+            this->write(text.data(), (int)text.size());
+        }
+
+        void write(const char c) {
+            if (this->size == this->capacity) {
+                this->flush();
+            }
+            this->buffer[this->size++] = c;
+        }
+
+        void write(int value) { // format the number ourselves, no need for a stream here
+            char digits[12];
+            int pos = 12;
+            bool negative = value < 0;
+            unsigned int magnitude = negative ? 0u - (unsigned int)value : (unsigned int)value;
+            do {
+                digits[--pos] = (char)('0' + magnitude % 10);
+                magnitude /= 10;
+            } while (magnitude);
+            if (negative) {
+                digits[--pos] = '-';
+            }
+            this->write(digits + pos, 12 - pos);
+        }
+
+        void writeField(const std::string_view text, const char delimiter) { // quotes the field only if it needs it
+            // the importer trims spaces and '\r' around unquoted fields, and splits records at unquoted newlines
+            bool plain = text.find(delimiter) == std::string_view::npos && text.find('"') == std::string_view::npos
+                && text.find('\n') == std::string_view::npos && text.find('\r') == std::string_view::npos
+                && (text.empty() || (text.front() != ' ' && text.back() != ' '));
+            if (plain) {
+                this->write(text);
+                return;
+            }
+            this->write('"');
+            for (char c : text) {
+                if (c == '"') {
+                    this->write('"'); // escape quotes by doubling them
+                }
+                this->write(c);
+            }
+            this->write('"');
+        }
+};
+
+class Garage; // forward declaration, since the journal replays its records into a Garage (defined further down)
+
+class GarageJournal { // durable storage for the garage: an append-only write-ahead log plus periodic snapshots
+    // every add/update/delete is appended to "<base>.log" as a self-contained record (the full row, not a diff)
+    // so replaying the log on top of the last snapshot ("<base>.snap") rebuilds exactly the garage we had
+    // records are not written one by one: they are gathered in a buffer and written + fsync-ed together (group commit)
+    // which is what makes 100k+ mutations per second possible, since the fsync is by far the most expensive part
+    private:
+        enum RecordType : unsigned char { RECORD_ADD = 1, RECORD_UPDATE = 2, RECORD_DELETE = 3 };
+        static const unsigned int LOG_MAGIC = 0x4C364857; // "WH6L" when read as bytes
+        static const unsigned int SNAPSHOT_MAGIC = 0x53364857; // "WH6S"
+        static const unsigned int CHECKSUM_START = 2166136261u; // FNV-1a's starting value
+        static const int SNAPSHOT_CHUNK = 1 << 20; // a snapshot is written 1 MB at a time, so it never has to fit in memory
+
+        std::string logPath;
+        std::string snapshotPath;
+        std::string snapshotTmpPath;
+        FILE* logFile = nullptr; // C-style file, since we need its descriptor for fsync (an std::ofstream doesn't expose it)
+        char* buffer = nullptr; // records waiting for the next group commit
+        long long bufferSize = 0;
+        long long bufferCapacity = 0;
+        int pendingRecords = 0;
+        int groupSize; // commit automatically after this many records
+        int recordsSinceSnapshot = 0;
+        int snapshotInterval; // ask for a snapshot after this many logged records
+        unsigned int generation = 0; // increased by every snapshot; a log only applies on top of the snapshot with the same generation
+
+        // FNV-1a, detects torn or corrupted records; passing the result back in as "h" continues it over the next piece,
+        // so a file written (or read) in parts gets the same checksum as if it was done in one go
+        static unsigned int checksum(const char* data, const long long length, unsigned int h = GarageJournal::CHECKSUM_START) {
+            for (long long i = 0; i < length; i++) {
+                h ^= (unsigned char)data[i];
+                h *= 16777619u;
+            }
+            return h;
+        }
+
+        static bool syncFile(FILE* file) { // push the data from the C library buffers, then from the OS cache to the disk
+            if (fflush(file) != 0) {
+                return false;
+            }
+#ifdef _WIN32
+            return _commit(_fileno(file)) == 0;
+#else
+            return fsync(fileno(file)) == 0;
+#endif
+        }
+
+        void reserve(const long long extra) {
+            if (this->bufferSize + extra <= this->bufferCapacity) {
+                return;
+            }
+            long long newCapacity = this->bufferCapacity ? this->bufferCapacity * 2 : 64 * 1024;
+            while (newCapacity < this->bufferSize + extra) {
+                newCapacity *= 2;
+            }
+            char* tmp = new char[newCapacity];
+            if (this->bufferSize > 0) {
+                memcpy(tmp, this->buffer, this->bufferSize);
+            }
+            delete[] this->buffer;
+            this->buffer = tmp;
+            this->bufferCapacity = newCapacity;
+        }
+
+        void put(const void* data, const long long length) { // append raw bytes to the pending buffer
+            this->reserve(length);
+            memcpy(this->buffer + this->bufferSize, data, length);
+            this->bufferSize += length;
+        }
+
+        void putRow(const unsigned char type, const int ID, const Vehicle& vehicle) {
+            // layout: [payload length][checksum][type][ID][year][vehicle type][make length][make][model length][model]
+            std::string_view make = vehicle.getMake();
+            std::string_view model = vehicle.getModel();
+            int makeLength = (int)make.size();
+            int modelLength = (int)model.size();
+            int year = vehicle.getYear();
+            unsigned char vehicleType = (unsigned char)vehicle.getVehicleType();
+            int payloadLength = 1 + 4 + 4 + 1 + 4 + makeLength + 4 + modelLength;
+
+            this->reserve(8 + payloadLength);
+            long long start = this->bufferSize;
+            this->bufferSize += 8; // leave room for the length and checksum, we fill them in once the payload is written
+            this->put(&type, 1);
+            this->put(&ID, 4);
+            this->put(&year, 4);
+            this->put(&vehicleType, 1);
+            this->put(&makeLength, 4);
+            this->put(make.data(), makeLength);
+            this->put(&modelLength, 4);
+            this->put(model.data(), modelLength);
+            unsigned int sum = GarageJournal::checksum(this->buffer + start + 8, payloadLength);
+            memcpy(this->buffer + start, &payloadLength, 4);
+            memcpy(this->buffer + start + 4, &sum, 4);
+        }
+
+        void logged() { // bookkeeping after every appended record
+            this->pendingRecords++;
+            this->recordsSinceSnapshot++;
+            if (this->pendingRecords >= this->groupSize) {
+                this->commit();
+            }
+        }
+
+        bool openLog(const bool truncate) {
+            if (this->logFile) {
+                fclose(this->logFile);
+                this->logFile = nullptr;
+            }
+            this->logFile = fopen(this->logPath.c_str(), truncate ? "wb" : "ab");
+            if (!this->logFile) {
+                std::cout << std::endl << "Cannot open the garage log!" << std::endl;
+                return false;
+            }
+            if (truncate) { // a fresh log starts with a header telling which snapshot it belongs to
+                unsigned int header[2] = { GarageJournal::LOG_MAGIC, this->generation };
+                fwrite(header, sizeof(header), 1, this->logFile);
+                return GarageJournal::syncFile(this->logFile);
+            }
+            return true;
+        }
+
+        static bool validSnapshot(const char* data, const long long length) { // the header is ours and the checksum at the end matches
+            if (length < 20) {
+                return false;
+            }
+            unsigned int magic;
+            unsigned int sum;
+            memcpy(&magic, data, sizeof(magic));
+            memcpy(&sum, data + length - 4, sizeof(sum));
+            return magic == GarageJournal::SNAPSHOT_MAGIC && GarageJournal::checksum(data, length - 4) == sum;
+        }
+
+        static bool fileExists(const std::string& path) {
+            std::ifstream ifs(path, std::ios::binary);
+            return ifs.is_open();
         }
 
-        std::string getModel() const {
-            return this->model;
+        // decode the record at "offset"; returns the offset of the next record, or -1 if the record is torn/corrupted
+        static long long readRecord(const char* data, const long long length, const long long offset, unsigned char& type, int& ID, int& year,
+            unsigned char& vehicleType, std::string& make, std::string& model) {
+            if (length - offset < 8) {
+                return -1;
+            }
+            int payloadLength;
+            unsigned int sum;
+            memcpy(&payloadLength, data + offset, 4);
+            memcpy(&sum, data + offset + 4, 4);
+            if (payloadLength < 18 || (long long)payloadLength > length - offset - 8) {
+                return -1;
+            }
+            const char* payload = data + offset + 8;
+            if (GarageJournal::checksum(payload, payloadLength) != sum) {
+                return -1;
+            }
+            int makeLength, modelLength;
+            type = (unsigned char)payload[0];
+            memcpy(&ID, payload + 1, 4);
+            memcpy(&year, payload + 5, 4);
+            vehicleType = (unsigned char)payload[9];
+            memcpy(&makeLength, payload + 10, 4);
+            if (makeLength < 0 || makeLength > payloadLength - 18) {
+                return -1;
+            }
+            memcpy(&modelLength, payload + 14 + makeLength, 4);
+            if (modelLength != payloadLength - 18 - makeLength) {
+                return -1;
+            }
+            make.assign(payload + 14, makeLength);
+            model.assign(payload + 18 + makeLength, modelLength);
+            return offset + 8 + payloadLength;
         }
 
-        VehicleType getVehicleType() const {
-            return this->vehicleType;
+    public:
+        GarageJournal(const std::string& basePath, const int groupSize = 1024, const int snapshotInterval = 200000) :
+            logPath(basePath + ".log"), snapshotPath(basePath + ".snap"), snapshotTmpPath(basePath + ".snap.tmp"),
+            groupSize(groupSize > 0 ? groupSize : 1), snapshotInterval(snapshotInterval > 0 ? snapshotInterval : 1) { }
+
+        GarageJournal(const GarageJournal&) = delete;
+        GarageJournal& operator=(const GarageJournal&) = delete;
+
+        ~GarageJournal() {
+            this->commit(); // never lose what's still in the buffer on a clean exit
+            if (this->logFile) {
+                fclose(this->logFile);
+                this->logFile = nullptr;
+            }
+            delete[] this->buffer;
+            this->buffer = nullptr;
         }
 
-        int getYear() const {
-            return this->year;
+        void logAdd(const Vehicle& vehicle) {
+            this->putRow(RECORD_ADD, vehicle.getID(), vehicle);
+            this->logged();
         }
 
-        int getID() const {
-            return this->ID;
+        void logUpdate(const Vehicle& vehicle) { // we log the state after the update, so replaying it twice is harmless
+            this->putRow(RECORD_UPDATE, vehicle.getID(), vehicle);
+            this->logged();
         }
 
-        void setMake(const std::string& make) {
-            if (!make.empty()) {
-                this->make = make;
-            }
-            else {
-                std::cout << std::endl << "Make cannot be empty!" << std::endl;
-                // leave it unchanged if fail
-            }
+        void logDelete(const int ID) {
+            this->putRow(RECORD_DELETE, ID, Vehicle());
+            this->logged();
         }
 
-        void setModel(const std::string& model) {
-            if (!model.empty()) {
-                this->model = model; // this actually copies the string, rather than directly moving the string from the outside into our class
-                // so it is safe to make const + "&" for containers which implement copy constructor + assignment op (which copies), such as std::string
+        bool commit() { // group commit: one write and one fsync for every record gathered since the last commit
+            if (!this->logFile) { // nothing we log can reach the disk, so never report it as durable
+                return false;
             }
-            else {
-                std::cout << std::endl << "Model cannot be empty!" << std::endl;
+            if (this->pendingRecords == 0) {
+                return true;
+            }
+            bool ok = fwrite(this->buffer, 1, this->bufferSize, this->logFile) == (size_t)this->bufferSize;
+            ok = ok && GarageJournal::syncFile(this->logFile);
+            this->bufferSize = 0;
+            this->pendingRecords = 0;
+            if (!ok) {
+                std::cout << std::endl << "Writing to the garage log failed!" << std::endl;
             }
+            return ok;
         }
 
-        void setVehicleType(const VehicleType vehicleType) {
-            this->vehicleType = vehicleType;
+        bool shouldSnapshot() const {
+            return this->recordsSinceSnapshot >= this->snapshotInterval;
         }
 
-        void setYear(int year) {
-            if (year > -1 && year < 2026) {
-                this->year = year;
-            }
-            else {
-                std::cout << std::endl << "Year cannot be negative or bigger than the current year!" << std::endl;
-            }
+        bool writeSnapshotChunk(FILE* file, unsigned int& sum) { // writes out the buffer, adding it to the running checksum
+            sum = GarageJournal::checksum(this->buffer, this->bufferSize, sum);
+            bool ok = fwrite(this->buffer, 1, (size_t)this->bufferSize, file) == (size_t)this->bufferSize;
+            this->bufferSize = 0;
+            return ok;
         }
 
-        static VehicleType stringToVehicleType(std::string vehicleTypeStr) {
-            for (auto& c : vehicleTypeStr) { // for each - only works for containers, such as std::string and STL ones (which we'll see in the future)
-                // SYNTAX: for (dataType variableToIterateWith : container)
-                // auto keyword determines automatically the type of variable
-                // beware, the auto keyword is to be used only in such constructs (i.e. when working with iterators over various containers)
-                // we use & to make it use references to actual characters from the string, such that modifications will be reflected in the string itself
-                c = (char)std::toupper((unsigned char)c); // capitalize each letter from our string, normalizing it to uppercase for match
-                // casts are a bit odd, but toupper requires and returns an int (either EOF or unsigned char value), and then we iterate over the string with the "char" type
-                // so all we do is ensure the correct types are used
-                // allows users to type in whatever case they want for the type and for it to still be correct
+        bool writeSnapshot(const Vehicle* vehicles, const int count) {
+            // write everything to a temporary file first, and only replace the old snapshot once the new one is safely on disk
+            // a crash at any point leaves us with either the old snapshot + old log, or the new snapshot (+ a log it ignores)
+            // the rows go out through the buffer 1 MB at a time, with the checksum kept up to date as we go
+            this->commit();
+            this->bufferSize = 0;
+            FILE* file = fopen(this->snapshotTmpPath.c_str(), "wb");
+            bool ok = file != nullptr;
+            unsigned int sum = GarageJournal::CHECKSUM_START;
+            unsigned int header[2] = { GarageJournal::SNAPSHOT_MAGIC, this->generation + 1 };
+            int counters[2] = { count, Vehicle::getNextID() };
+            this->put(header, sizeof(header));
+            this->put(counters, sizeof(counters));
+            for (int i = 0; i < count && ok; i++) {
+                this->putRow(RECORD_ADD, vehicles[i].getID(), vehicles[i]);
+                if (this->bufferSize >= GarageJournal::SNAPSHOT_CHUNK) {
+                    ok = this->writeSnapshotChunk(file, sum);
+                }
             }
-            for (int i = 0; i < Vehicle::mapItems; i++) {
-                if (Vehicle::changeMap[i].first == vehicleTypeStr) {
-                    return Vehicle::changeMap[i].second;
+            ok = ok && this->writeSnapshotChunk(file, sum);
+            ok = ok && fwrite(&sum, sizeof(sum), 1, file) == 1; // the checksum of everything before it
+            ok = ok && GarageJournal::syncFile(file);
+            if (file) {
+                fclose(file);
+            }
+            this->bufferSize = 0;
+            if (!ok) {
+                std::cout << std::endl << "Writing the garage snapshot failed!" << std::endl;
+                std::remove(this->snapshotTmpPath.c_str());
+                // the old snapshot + log still hold everything, so keep appending to that log
+                // (after recovery the log is closed until the first snapshot, so it may have to be opened again)
+                if (!this->logFile) {
+                    this->openLog(false);
                 }
+                return false;
             }
-            return VehicleType::UNKNOWN; // return unknown if nothing was found
+            std::remove(this->snapshotPath.c_str()); // std::rename refuses to overwrite an existing file on Windows
+            if (std::rename(this->snapshotTmpPath.c_str(), this->snapshotPath.c_str()) != 0) {
+                // the old snapshot is gone, but the new one is complete in the temporary file, and recovery takes it from there;
+                // so we still move on to the new generation, otherwise the changes logged from now on would be ignored
+                std::cout << std::endl << "Replacing the garage snapshot failed!" << std::endl;
+            }
+            this->generation++;
+            this->recordsSinceSnapshot = 0;
+            return this->openLog(true); // the snapshot already contains everything, so start an empty log for the new generation
         }
 
-        static std::string vehicleTypeToString(const VehicleType vehicleType) {
-            for (int i = 0; i < Vehicle::mapItems; i++) {
-                if (Vehicle::changeMap[i].second == vehicleType) {
-                    return Vehicle::changeMap[i].first;
-                }
-            }
-            return "UNKNOWN"; // return unknown if nothing was found
+        bool isOpen() const { // whether changes can be logged at all
+            return this->logFile != nullptr;
         }
-};
 
-int Vehicle::idCounter = 1; // 1-index
-Pair Vehicle::changeMap[] = { // create a list of key-value pairs (a map - analogous to dictionaries in Python), useful for mapping strings to vehicle types and vice-versa
-            { "SEDAN", VehicleType::SEDAN },
-            { "COUPE", VehicleType::COUPE },
-            { "HATCHBACK", VehicleType::HATCHBACK },
-            { "MINIVAN", VehicleType::MINIVAN },
-            { "CONVERTIBLE", VehicleType::CONVERTIBLE },
-            { "SUV", VehicleType::SUV },
-            { "PICKUP", VehicleType::PICKUP },
-            { "UNKNOWN", VehicleType::UNKNOWN },
+        int recover(Garage& garage); // loads the snapshot and replays the log into an empty garage, defined after Garage
 };
-int Vehicle::mapItems = sizeof(Vehicle::changeMap) / sizeof(Vehicle::changeMap[0]); // works since changeMap is a static array (it won't work for dynamic ones)
 
 class Garage {
     private:
         Vehicle* vehicles = nullptr;
         int size = 0; // current size of the list (i.e. index + 1 of last element)
         int capacity = 0; // capacity (max amount of elements it can hold) of the list
+        VehicleColumns columns; // columnar copy of the same vehicles, kept in sync on every change and used for filtered searches
+        GarageJournal* journal = nullptr; // optional durable log of every change (not owned by the garage)
+        VehicleIndexes indexes; // secondary indexes on make, model, type and year, used by "query"
 
-        void resize() { // keep the resizing function private, as we don't want it accessible from the outside
-            int newCapacity = this->capacity + 100;
+        void resize(int newCapacity = 0) { // keep the resizing function private, as we don't want it accessible from the outside
+            if (newCapacity <= this->capacity) { // no explicit capacity asked for, so grow by the usual amount
+                newCapacity = this->capacity < 100 ? this->capacity + 100 : this->capacity * 2; // grow geometrically once the garage gets big
+                // otherwise, replaying a long log would copy the whole garage every 100 vehicles
+            }
             Vehicle* newVehicles = new Vehicle[newCapacity]; // calls default constructor, but no ID changes
             // default constructor uses placeholder ID, and we then copy-assign to preserve original IDs
 
@@ -165,14 +1520,32 @@ class Garage {
         }
 
         int indexOfID(const int ID) const { // helper for getting the correct index for the ID
-            for (int i = 0; i < this->size; ++i) {
-                if (this->vehicles[i].getID() == ID)  {
-                    return i;
+            // vehicles are always appended with increasing IDs, and deleting shifts the rest without changing their order
+            // so the array is sorted by ID, and we can binary search it instead of checking every vehicle
+            int left = 0;
+            int right = this->size - 1;
+            while (left <= right) {
+                int middle = left + (right - left) / 2;
+                int middleID = this->vehicles[middle].getID();
+                if (middleID == ID) {
+                    return middle;
+                }
+                if (middleID < ID) {
+                    left = middle + 1;
+                }
+                else {
+                    right = middle - 1;
                 }
             }
             return -1;
         }
 
+        void checkpointIfNeeded() {
+            if (this->journal->shouldSnapshot()) {
+                this->journal->writeSnapshot(this->vehicles, this->size);
+            }
+        }
+
     public:
         // since we initialized the variables where we defined them in the "private" field, we don't need a default constructor anymore
         // those initializations act as the default constructor
@@ -190,10 +1563,90 @@ class Garage {
         }
 
         void addVehicle(const std::string& make, const std::string& model, const std::string& vehicleTypeStr, const int year) {
+            this->addVehicle(make, model, Vehicle::stringToVehicleType(vehicleTypeStr), year);
+        }
+
+        void addVehicle(const std::string& make, const std::string& model, const VehicleType vehicleType, const int year) {
             if (this->size == this->capacity) { // if we are at max capacity
                 this->resize();
             }
-            this->vehicles[this->size++] = Vehicle(make, model, Vehicle::stringToVehicleType(vehicleTypeStr), year);
+            this->vehicles[this->size] = Vehicle(make, model, vehicleType, year);
+            this->columns.append(this->vehicles[this->size]);
+            this->indexes.add(this->vehicles[this->size]);
+            this->size++;
+            if (this->journal) {
+                this->journal->logAdd(this->vehicles[this->size - 1]);
+                this->checkpointIfNeeded();
+            }
+        }
+
+        void reserve(const int newCapacity) { // make room for many vehicles at once, e.g. before a bulk import
+            if (newCapacity > this->capacity) {
+                this->resize(newCapacity);
+            }
+            this->columns.reserve(newCapacity);
+        }
+
+        void restoreVehicle(const Vehicle& vehicle) { // adds an already built vehicle (keeping its ID), without logging it
+            if (this->size == this->capacity) {
+                this->resize();
+            }
+            // the vehicles array has to stay sorted by ID (see indexOfID); restored vehicles normally come in increasing order
+            // but with several threads, a vehicle created a bit later can reach the garage first, so then we shift it into place
+            int pos = this->size;
+            while (pos > 0 && this->vehicles[pos - 1].getID() > vehicle.getID()) {
+                this->vehicles[pos] = this->vehicles[pos - 1];
+                pos--;
+            }
+            this->vehicles[pos] = vehicle;
+            if (pos == this->size) {
+                this->columns.append(vehicle);
+            }
+            else {
+                this->columns.insert(pos, vehicle);
+            }
+            this->indexes.add(vehicle);
+            this->size++;
+        }
+
+        bool contains(const int ID) const {
+            return this->indexOfID(ID) != -1;
+        }
+
+        bool getVehicle(const int ID, Vehicle& vehicle) const { // copies a vehicle out, without printing anything
+            int idx = this->indexOfID(ID);
+            if (idx == -1) {
+                return false;
+            }
+            vehicle = this->vehicles[idx];
+            return true;
+        }
+
+        int getSize() const {
+            return this->size;
+        }
+
+        int attachJournal(GarageJournal* journal) { // restore the garage from disk, then log every change from now on
+            // returns the number of replayed log records, or -1 if the saved state could not be read
+            int replayed = journal->recover(*this);
+            if (replayed < 0) {
+                return -1;
+            }
+            this->journal = journal;
+            if (replayed > 0) { // fold the replayed log into a fresh snapshot, so the next startup doesn't replay it again
+                if (!this->journal->writeSnapshot(this->vehicles, this->size)) {
+                    // not fatal: the log we just replayed is still there, and new changes are appended to it
+                    std::cout << std::endl << "Could not fold the garage log into a new snapshot, it will be replayed again next time." << std::endl;
+                    if (!this->journal->isOpen()) {
+                        return -1;
+                    }
+                }
+            }
+            return replayed;
+        }
+
+        bool commit() { // make every change so far durable
+            return this->journal ? this->journal->commit() : true;
         }
 
         bool readVehicle(const int ID) const {
@@ -222,10 +1675,17 @@ class Garage {
                 std::cout << std::endl << "Invalid ID given for update!" << std::endl;
                 return false;
             }
+            this->indexes.remove(this->vehicles[idx]); // un-index the old values, before the setters change them
             this->vehicles[idx].setMake(make);
             this->vehicles[idx].setModel(model);
             this->vehicles[idx].setYear(year);
             this->vehicles[idx].setVehicleType(Vehicle::stringToVehicleType(vehicleTypeStr));
+            this->columns.set(idx, this->vehicles[idx]); // setters might have rejected some values, so copy whatever the vehicle ended up with
+            this->indexes.add(this->vehicles[idx]);
+            if (this->journal) {
+                this->journal->logUpdate(this->vehicles[idx]);
+                this->checkpointIfNeeded();
+            }
             return true;
         }
 
@@ -235,11 +1695,236 @@ class Garage {
                 std::cout << std::endl << "Invalid ID given for delete!" << std::endl;
                 return false;
             } // reset it to default values, but still keep it in the list for future usage
+            this->indexes.remove(this->vehicles[idx]);
             for (int i = idx + 1; i < this->size; i++) {
                 this->vehicles[i - 1] = this->vehicles[i]; // essentially remove the element in the list
                 // by shifting everything to the right of it 1 position to the left
             }
             this->vehicles[--this->size] = Vehicle(); // reflect change in size and clear the last slot
+            this->columns.remove(idx);
+            if (this->journal) {
+                this->journal->logDelete(ID);
+                this->checkpointIfNeeded();
+            }
+            return true;
+        }
+
+        // searches run over the columns rather than the vehicles array, so they never touch the make/model strings
+        // they return a dynamic array of matching IDs (or nullptr if none), which the caller has to clean up
+        int* findByTypeAndYear(const std::string& vehicleTypeStr, const int minYear, const int maxYear, int& count) const {
+            return this->columns.selectByTypeAndYear(Vehicle::stringToVehicleType(vehicleTypeStr), minYear, maxYear, count);
+        }
+
+        int* findByYear(const int minYear, const int maxYear, int& count) const {
+            return this->columns.selectByYear(minYear, maxYear, count);
+        }
+
+        int* findByMake(const std::string& make, int& count) const {
+            return this->columns.selectByMake(make, count);
+        }
+
+        int* findByModel(const std::string& model, int& count) const {
+            return this->columns.selectByModel(model, count);
+        }
+
+        // combined search using the secondary indexes, so something like "Toyota SUVs after 2018" doesn't scan the whole garage
+        // returns a dynamic array with the matching IDs (sorted), or nullptr if none; the caller has to clean it up
+        int* query(const VehicleQuery& filter, int& count) const {
+            count = 0;
+            int minYear = filter.minYear < 0 ? 0 : filter.minYear;
+            int maxYear = filter.maxYear > 2025 ? 2025 : filter.maxYear;
+            if (minYear > maxYear || this->size == 0) {
+                return nullptr;
+            }
+            bool filterYear = minYear > 0 || maxYear < 2025;
+
+            // collect the ID lists of the equality filters
+            const IdList* lists[3];
+            int listCount = 0;
+            if (!filter.make.empty()) {
+                lists[listCount] = this->indexes.findMake(filter.make);
+                if (!lists[listCount++]) {
+                    return nullptr; // unknown make, nothing can match
+                }
+            }
+            if (!filter.model.empty()) {
+                lists[listCount] = this->indexes.findModel(filter.model);
+                if (!lists[listCount++]) {
+                    return nullptr;
+                }
+            }
+            if (!filter.vehicleType.empty()) {
+                lists[listCount++] = &this->indexes.findType(Vehicle::stringToVehicleType(filter.vehicleType));
+            }
+
+            int yearCount = 0;
+            for (int year = minYear; year <= maxYear; year++) {
+                yearCount += this->indexes.findYear(year).getSize();
+            }
+
+            // drive the intersection from the smallest candidate set, and only probe the other ones
+            int smallest = -1;
+            for (int i = 0; i < listCount; i++) {
+                if (smallest == -1 || lists[i]->getSize() < lists[smallest]->getSize()) {
+                    smallest = i;
+                }
+            }
+
+            int* result = nullptr;
+            if (smallest == -1 || (filterYear && yearCount < lists[smallest]->getSize())) {
+                // the year range is the most selective filter: walk its buckets and probe the equality lists
+                result = yearCount ? new int[yearCount] : nullptr;
+                for (int year = minYear; year <= maxYear; year++) {
+                    const IdList& bucket = this->indexes.findYear(year);
+                    for (int i = 0; i < bucket.getSize(); i++) {
+                        bool match = true;
+                        for (int k = 0; k < listCount && match; k++) {
+                            match = lists[k]->contains(bucket.getIDs()[i]);
+                        }
+                        if (match) {
+                            result[count++] = bucket.getIDs()[i];
+                        }
+                    }
+                }
+                std::sort(result, result + count); // each bucket is sorted, but not in between each other
+            }
+            else {
+                // an equality list is the most selective one: walk it (it's already sorted) and probe the others
+                // the year is checked on the vehicle itself, since a binary search by ID is cheaper than probing every year bucket
+                const IdList* driver = lists[smallest];
+                result = driver->getSize() ? new int[driver->getSize()] : nullptr;
+                for (int i = 0; i < driver->getSize(); i++) {
+                    int ID = driver->getIDs()[i];
+                    bool match = true;
+                    for (int k = 0; k < listCount && match; k++) {
+                        match = k == smallest || lists[k]->contains(ID);
+                    }
+                    if (match && filterYear) {
+                        int year = this->vehicles[this->indexOfID(ID)].getYear();
+                        match = year >= minYear && year <= maxYear;
+                    }
+                    if (match) {
+                        result[count++] = ID;
+                    }
+                }
+            }
+            if (count == 0) {
+                delete[] result;
+                result = nullptr;
+            }
+            return result;
+        }
+
+        // bulk import of a "make,model,type,year" CSV (or TSV) file; a header line is allowed and skipped
+        // the file is memory-mapped and split into one chunk per thread at record boundaries, every thread parses its chunk
+        // and then all records are inserted in file order after a single reserve
+        // the records are not logged one by one: the whole import goes to disk as one snapshot at the end, so a crash
+        // leaves either the garage from before the import or the one with all of it, never a part of it
+        bool importCSV(const std::string& path, int& imported, int& rejected) {
+            imported = 0;
+            rejected = 0;
+            MappedFile file;
+            if (!file.open(path)) {
+                std::cout << std::endl << "Cannot open " << path << "!" << std::endl;
+                return false;
+            }
+            const char* begin = file.getData();
+            const char* end = begin + file.getSize();
+            if (begin == end) {
+                return true;
+            }
+
+            // the first line decides the delimiter, and is skipped if it's a header
+            const char* firstLineEnd = VehicleCsvChunk::recordEnd(begin, end, false);
+            std::string_view firstLine(begin, firstLineEnd - begin);
+            const char delimiter = firstLine.find('\t') != std::string_view::npos ? '\t' : ',';
+            std::string_view firstField = firstLine.substr(0, firstLine.find(delimiter));
+            if (firstField.size() == 4 && (firstField[0] == 'm' || firstField[0] == 'M') && (firstField[1] == 'a' || firstField[1] == 'A')
+                && (firstField[2] == 'k' || firstField[2] == 'K') && (firstField[3] == 'e' || firstField[3] == 'E')) {
+                begin = firstLineEnd < end ? firstLineEnd + 1 : end;
+            }
+
+            // no point in starting a thread for less than a few MB
+            long long length = end - begin;
+            int threadCount = (int)std::thread::hardware_concurrency();
+            if (threadCount < 1) {
+                threadCount = 1;
+            }
+            if (length / threadCount < (4 << 20)) {
+                threadCount = (int)(length / (4 << 20)) + 1;
+            }
+
+            VehicleCsvChunk* chunks = new VehicleCsvChunk[threadCount];
+            std::thread* threads = new std::thread[threadCount];
+            const char* chunkStart = begin;
+            for (int i = 0; i < threadCount; i++) {
+                // aim for an equal share, then move the boundary forward to the next record start, so no record gets split
+                // (the quotes since the previous boundary tell whether we landed inside a quoted field)
+                const char* chunkEnd = i == threadCount - 1 ? end : begin + length / threadCount * (i + 1);
+                if (chunkEnd < chunkStart) {
+                    chunkEnd = chunkStart;
+                }
+                if (chunkEnd < end) {
+                    chunkEnd = VehicleCsvChunk::recordEnd(chunkEnd, end, VehicleCsvChunk::insideQuotes(chunkStart, chunkEnd));
+                    chunkEnd = chunkEnd < end ? chunkEnd + 1 : end;
+                }
+                // a thread runs the given function with the given arguments, in parallel with us
+                threads[i] = std::thread(&VehicleCsvChunk::parse, &chunks[i], chunkStart, chunkEnd, delimiter);
+                chunkStart = chunkEnd;
+            }
+            int total = 0;
+            for (int i = 0; i < threadCount; i++) {
+                threads[i].join(); // wait for every thread to finish its chunk
+                total += chunks[i].getCount();
+                rejected += chunks[i].getRejected();
+            }
+            delete[] threads;
+            threads = nullptr;
+
+            int firstNew = this->size;
+            this->reserve(this->size + total); // one allocation for the whole import, instead of growing again and again
+            for (int i = 0; i < threadCount; i++) {
+                for (int k = 0; k < chunks[i].getCount(); k++) {
+                    const VehicleRecord& record = chunks[i].getRecord(k);
+                    // new vehicles get the highest IDs so far, so they always go at the end; nothing is logged yet
+                    this->restoreVehicle(Vehicle(record.make, record.model, record.vehicleType, record.year));
+                }
+            }
+            imported = total;
+            delete[] chunks;
+            chunks = nullptr;
+            if (!this->journal || total == 0) {
+                return true;
+            }
+            if (this->journal->writeSnapshot(this->vehicles, this->size)) { // commits what was logged before, then saves everything
+                return true;
+            }
+            // without the snapshot the new vehicles are only in memory, so fall back to logging them one by one
+            // (the failed snapshot left the old log open for that)
+            for (int i = firstNew; i < this->size; i++) {
+                this->journal->logAdd(this->vehicles[i]);
+            }
+            return this->commit();
+        }
+
+        bool exportCSV(const std::string& path) const { // the same layout importCSV reads, streamed through a 1 MB buffer
+            BufferedWriter writer(path);
+            writer.write(std::string_view("make,model,type,year\n"));
+            for (int i = 0; i < this->size; i++) {
+                const Vehicle& vehicle = this->vehicles[i];
+                writer.writeField(vehicle.getMake(), ',');
+                writer.write(',');
+                writer.writeField(vehicle.getModel(), ',');
+                writer.write(',');
+                writer.write(Vehicle::vehicleTypeToString(vehicle.getVehicleType()));
+                writer.write(',');
+                writer.write(vehicle.getYear());
+                writer.write('\n');
+            }
+            if (!writer.close()) {
+                std::cout << std::endl << "Cannot write " << path << "!" << std::endl;
+                return false;
+            }
             return true;
         }
 
@@ -252,13 +1937,312 @@ class Garage {
         }
 };
 
+class ConcurrentGarage { // a garage which many threads can use at the same time
+    // the vehicles are split into shards by ID (ID % SHARD_COUNT), every shard being a regular Garage with its own lock
+    // threads working on different shards never wait for each other, and readers of the same shard don't wait for each other either
+    // IDs come from Vehicle's atomic counter, so no lock is needed to pick one
+    private:
+        static const int SHARD_COUNT = 64; // deleting from a Garage shifts the rest of it, so smaller shards also make deletes cheaper
+
+        struct alignas(64) Shard { // aligned to a cache line, so two locks never share one (which would make the cores fight over it)
+            mutable std::shared_mutex lock; // many readers (shared_lock) or one writer (unique_lock) at a time
+            Garage garage;
+        };
+
+        Shard* shards = nullptr;
+
+        Shard& shardOf(const int ID) const {
+            return this->shards[(unsigned int)ID % ConcurrentGarage::SHARD_COUNT];
+        }
+
+    public:
+        ConcurrentGarage() {
+            this->shards = new Shard[ConcurrentGarage::SHARD_COUNT];
+        }
+
+        ConcurrentGarage(const ConcurrentGarage&) = delete;
+        ConcurrentGarage& operator=(const ConcurrentGarage&) = delete;
+
+        ~ConcurrentGarage() {
+            delete[] this->shards;
+            this->shards = nullptr;
+        }
+
+        int addVehicle(const std::string& make, const std::string& model, const VehicleType vehicleType, const int year) {
+            Vehicle vehicle(make, model, vehicleType, year); // built (and given its ID) outside of any lock
+            this->restoreVehicle(vehicle);
+            return vehicle.getID();
+        }
+
+        void restoreVehicle(const Vehicle& vehicle) { // adds an already built vehicle, keeping its ID
+            Shard& shard = this->shardOf(vehicle.getID());
+            std::unique_lock<std::shared_mutex> guard(shard.lock); // the lock is released automatically when "guard" goes out of scope
+            shard.garage.restoreVehicle(vehicle);
+        }
+
+        bool getVehicle(const int ID, Vehicle& vehicle) const {
+            Shard& shard = this->shardOf(ID);
+            std::shared_lock<std::shared_mutex> guard(shard.lock);
+            return shard.garage.getVehicle(ID, vehicle);
+        }
+
+        bool updateVehicle(const int ID, const std::string& make, const std::string& model, const std::string& vehicleTypeStr, const int year) {
+            Shard& shard = this->shardOf(ID);
+            std::unique_lock<std::shared_mutex> guard(shard.lock);
+            if (!shard.garage.contains(ID)) { // check first, so a vehicle deleted by another thread is not reported on the console
+                return false;
+            }
+            return shard.garage.updateVehicle(ID, make, model, vehicleTypeStr, year);
+        }
+
+        bool deleteVehicle(const int ID) {
+            Shard& shard = this->shardOf(ID);
+            std::unique_lock<std::shared_mutex> guard(shard.lock);
+            if (!shard.garage.contains(ID)) {
+                return false;
+            }
+            return shard.garage.deleteVehicle(ID);
+        }
+
+        int getSize() const { // every shard is locked on its own, so with concurrent writers this is only a snapshot
+            int total = 0;
+            for (int i = 0; i < ConcurrentGarage::SHARD_COUNT; i++) {
+                std::shared_lock<std::shared_mutex> guard(this->shards[i].lock);
+                total += this->shards[i].garage.getSize();
+            }
+            return total;
+        }
+
+        int* query(const VehicleQuery& filter, int& count) const { // runs the indexed query on every shard and merges the results
+            count = 0;
+            int* parts[ConcurrentGarage::SHARD_COUNT];
+            int partCounts[ConcurrentGarage::SHARD_COUNT];
+            for (int i = 0; i < ConcurrentGarage::SHARD_COUNT; i++) {
+                std::shared_lock<std::shared_mutex> guard(this->shards[i].lock);
+                parts[i] = this->shards[i].garage.query(filter, partCounts[i]);
+                count += partCounts[i];
+            }
+            int* result = count ? new int[count] : nullptr;
+            int pos = 0;
+            for (int i = 0; i < ConcurrentGarage::SHARD_COUNT; i++) {
+                if (partCounts[i] > 0) {
+                    memcpy(result + pos, parts[i], sizeof(int) * partCounts[i]);
+                    pos += partCounts[i];
+                }
+                delete[] parts[i];
+            }
+            std::sort(result, result + count); // every shard's part is sorted, but they interleave
+            return result;
+        }
+};
+
+void runConcurrentBenchmark() { // measures how the concurrent garage scales with the number of threads
+    // every thread runs a mix of 80% reads, 15% updates and 5% deletes (each delete followed by an add, so the size stays stable)
+    // on random vehicles, for a fixed amount of time; we then report the operations per second of each kind
+    // every thread keeps a table of the IDs it owns and picks from it, and a delete+add puts the new ID in the same slot,
+    // so the operations always find their vehicle, however many have been replaced; taking random IDs from a fixed range
+    // would miss more and more often, as the deleted IDs never come back
+    // the benchmark garage numbers its vehicles from firstID up, far below 0, where the real garage never goes: building a
+    // vehicle with a given ID only ever moves Vehicle's counter forward, so the IDs of the real vehicles are not used up
+    const int initialVehicles = 200000;
+    const int firstID = -1000000000;
+    const double secondsPerRun = 1.0;
+    const char* makes[] = { "Toyota", "Ford", "BMW", "Dacia", "Volkswagen" };
+    const char* models[] = { "Corolla", "Focus", "X5", "Logan", "Golf" };
+    const char* types[] = { "SEDAN", "SUV", "HATCHBACK", "PICKUP" };
+
+    int maxThreads = (int)std::thread::hardware_concurrency();
+    if (maxThreads < 1) {
+        maxThreads = 1;
+    }
+    std::cout << std::endl << "Threads | reads/s | updates/s | deletes+adds/s | total ops/s" << std::endl;
+    for (int threadCount = 1; threadCount <= maxThreads * 2; threadCount *= 2) {
+        ConcurrentGarage* garage = new ConcurrentGarage;
+        for (int i = 0; i < initialVehicles; i++) { // in increasing ID order, so every vehicle goes at the end of its shard
+            garage->restoreVehicle(Vehicle(firstID + i, makes[i % 5], models[i % 5], (VehicleType)(i % 7), 1990 + i % 36));
+        }
+
+        // thread t owns the vehicles i with i % threadCount == t, and later the new ones firstID + initialVehicles + t + n * threadCount
+        int** owned = new int*[threadCount];
+        int* ownedCounts = new int[threadCount];
+        for (int t = 0; t < threadCount; t++) {
+            ownedCounts[t] = (initialVehicles - t + threadCount - 1) / threadCount;
+            owned[t] = new int[ownedCounts[t]];
+            for (int i = 0; i < ownedCounts[t]; i++) {
+                owned[t][i] = firstID + t + i * threadCount;
+            }
+        }
+
+        std::atomic<bool> stop(false);
+        long long* reads = new long long[threadCount];
+        long long* updates = new long long[threadCount];
+        long long* deletes = new long long[threadCount];
+        std::thread* threads = new std::thread[threadCount];
+        for (int t = 0; t < threadCount; t++) {
+            reads[t] = updates[t] = deletes[t] = 0;
+            // a lambda is an unnamed function written in place; [&] lets it use our local variables by reference, and "t" is copied
+            threads[t] = std::thread([&, t]() {
+                unsigned int state = 2463534242u + t * 7919u; // xorshift, a tiny per-thread random generator (rand() is not thread-safe)
+                int* IDs = owned[t];
+                int nextID = firstID + initialVehicles + t;
+                Vehicle vehicle;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    state ^= state << 13;
+                    state ^= state >> 17;
+                    state ^= state << 5;
+                    int slot = (int)(state % (unsigned int)ownedCounts[t]);
+                    int dice = (int)((state >> 8) % 100);
+                    if (dice < 80) {
+                        garage->getVehicle(IDs[slot], vehicle);
+                        reads[t]++;
+                    }
+                    else if (dice < 95) {
+                        garage->updateVehicle(IDs[slot], makes[dice % 5], models[dice % 5], types[dice % 4], 2000 + dice % 20);
+                        updates[t]++;
+                    }
+                    else {
+                        if (garage->deleteVehicle(IDs[slot])) {
+                            garage->restoreVehicle(Vehicle(nextID, makes[dice % 5], models[dice % 5], VehicleType::SEDAN, 2015));
+                            IDs[slot] = nextID;
+                            nextID += threadCount;
+                        }
+                        deletes[t]++;
+                    }
+                }
+            });
+        }
+        auto start = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(std::chrono::duration<double>(secondsPerRun));
+        stop = true;
+        for (int t = 0; t < threadCount; t++) {
+            threads[t].join();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        long long totalReads = 0, totalUpdates = 0, totalDeletes = 0;
+        for (int t = 0; t < threadCount; t++) {
+            totalReads += reads[t];
+            totalUpdates += updates[t];
+            totalDeletes += deletes[t];
+        }
+        std::cout << threadCount << " | " << (long long)(totalReads / seconds) << " | " << (long long)(totalUpdates / seconds) << " | "
+            << (long long)(totalDeletes / seconds) << " | " << (long long)((totalReads + totalUpdates + totalDeletes) / seconds) << std::endl;
+
+        delete[] threads;
+        delete[] reads;
+        delete[] updates;
+        delete[] deletes;
+        for (int t = 0; t < threadCount; t++) {
+            delete[] owned[t];
+        }
+        delete[] owned;
+        delete[] ownedCounts;
+        delete garage;
+    }
+}
+
+int GarageJournal::recover(Garage& garage) {
+    // a leftover temporary snapshot only matters if the real one is missing; that happens when we crashed between removing
+    // the old snapshot and renaming (then it's complete, since it was fsync-ed before the old one was removed), but also
+    // when we crashed while writing the very first snapshot (then it's torn, and the log alone still has everything)
+    // so it only replaces the missing snapshot if it passes the same checks as a real one
+    // both files are memory-mapped rather than read into a buffer of ours, so a snapshot of any size can be restored
+    // every mapping is closed again before the file is renamed or rewritten (Windows doesn't allow that on a mapped file)
+    if (!GarageJournal::fileExists(this->snapshotPath) && GarageJournal::fileExists(this->snapshotTmpPath)) {
+        MappedFile tmp;
+        bool complete = tmp.open(this->snapshotTmpPath) && GarageJournal::validSnapshot(tmp.getData(), tmp.getSize());
+        tmp.close();
+        if (complete) {
+            std::rename(this->snapshotTmpPath.c_str(), this->snapshotPath.c_str());
+        }
+    }
+    std::remove(this->snapshotTmpPath.c_str());
+
+    unsigned char type, vehicleType;
+    int ID, year;
+    std::string make, model;
+
+    MappedFile file;
+    if (file.open(this->snapshotPath)) {
+        const char* data = file.getData();
+        long long length = file.getSize();
+        unsigned int header[2];
+        int counters[2];
+        bool ok = GarageJournal::validSnapshot(data, length);
+        if (ok) {
+            memcpy(header, data, sizeof(header));
+            memcpy(counters, data + 8, sizeof(counters));
+        }
+        if (!ok) {
+            std::cout << std::endl << "The garage snapshot is corrupted!" << std::endl;
+            return -1;
+        }
+        this->generation = header[1];
+        long long offset = 16;
+        for (int i = 0; i < counters[0]; i++) {
+            offset = GarageJournal::readRecord(data, length - 4, offset, type, ID, year, vehicleType, make, model);
+            if (offset < 0) {
+                std::cout << std::endl << "The garage snapshot is corrupted!" << std::endl;
+                return -1;
+            }
+            garage.restoreVehicle(Vehicle(ID, make, model, (VehicleType)vehicleType, year));
+        }
+        Vehicle::setNextID(counters[1]);
+    }
+
+    int replayed = 0;
+    if (file.open(this->logPath)) { // closes the snapshot first
+        const char* data = file.getData();
+        long long length = file.getSize();
+        unsigned int header[2] = { 0, 0 };
+        if (length >= 8) {
+            memcpy(header, data, sizeof(header));
+        }
+        // a log from an older generation was already folded into the snapshot (we crashed right before truncating it)
+        if (header[0] == GarageJournal::LOG_MAGIC && header[1] == this->generation) {
+            long long offset = 8;
+            while (offset < length) {
+                // stop at the first torn or corrupted record: it can only be the tail of a write interrupted by a crash
+                offset = GarageJournal::readRecord(data, length, offset, type, ID, year, vehicleType, make, model);
+                if (offset < 0) {
+                    break;
+                }
+                if (type == RECORD_ADD) {
+                    garage.restoreVehicle(Vehicle(ID, make, model, (VehicleType)vehicleType, year));
+                }
+                else if (type == RECORD_UPDATE) {
+                    garage.updateVehicle(ID, make, model, std::string(Vehicle::vehicleTypeToString((VehicleType)vehicleType)), year);
+                }
+                else if (type == RECORD_DELETE) {
+                    garage.deleteVehicle(ID);
+                }
+                replayed++;
+            }
+        }
+    }
+    file.close();
+    if (replayed == 0) {
+        // nothing to fold into a new snapshot, so just start a clean log for the current generation
+        // (this also drops a torn tail or a log left over from an older generation)
+        if (!this->openLog(true)) {
+            return -1;
+        }
+    }
+    return replayed;
+}
+
 void printMenu() { // helper for printing the menu
     std::cout << std::endl << "1. Add a vehicle" << std::endl;
     std::cout << "2. Show vehicle by ID" << std::endl;
     std::cout << "3. Show all vehicles" << std::endl;
     std::cout << "4. Update vehicle" << std::endl;
     std::cout << "5. Delete vehicle" << std::endl;
-    std::cout << "6. Exit" << std::endl;
+    std::cout << "6. Search vehicles by type and year range" << std::endl;
+    std::cout << "7. Search vehicles by make/model/type/year" << std::endl;
+    std::cout << "8. Import vehicles from a CSV/TSV file" << std::endl;
+    std::cout << "9. Export vehicles to a CSV file" << std::endl;
+    std::cout << "10. Run the concurrent garage benchmark" << std::endl;
+    std::cout << "11. Exit" << std::endl;
     std::cout << "Enter a choice: ";
 }
 
@@ -266,6 +2250,14 @@ int main()
 {   
     Garage* garage = new Garage; // default construct our garage for use
     // make it a ptr to spice things up a little
+    GarageJournal* journal = new GarageJournal("garage"); // keeps the garage in "garage.snap" + "garage.log", next to the executable
+    int replayed = garage->attachJournal(journal);
+    if (replayed < 0) {
+        std::cout << "Could not restore the saved garage, exiting." << std::endl;
+        delete garage;
+        delete journal;
+        return 1;
+    }
     int choice;
     while (true) {
         printMenu();
@@ -292,6 +2284,7 @@ int main()
                 continue;
             }
             garage->addVehicle(make, model, type, year);
+            garage->commit(); // only report success once the change is on disk
             std::cout << std::endl << "Vehicle added successfully!" << std::endl;
         }
         else if (choice == 2) { // read a vehicle by id
@@ -337,7 +2330,7 @@ int main()
                 continue;
             }
             bool res = garage->updateVehicle(ID, make, model, type, year);
-            if (res) {
+            if (res && garage->commit()) {
                 std::cout << std::endl << "Vehicle updated successfully!" << std::endl;
             }
         }
@@ -351,11 +2344,100 @@ int main()
                 continue;
             }
             bool res = garage->deleteVehicle(ID);
-            if (res) {
+            if (res && garage->commit()) {
                 std::cout << "Vehicle deleted successfully!" << std::endl;
             }
         }
-        else if (choice == 6) {
+        else if (choice == 6) { // search by type and year range
+            std::string type;
+            int minYear, maxYear;
+            std::cout << std::endl << "Enter vehicle type to search for (SEDAN/COUPE/HATCHBACK/MINIVAN/CONVERTIBLE/SUV/PICKUP/UNKNOWN): ";
+            std::getline(std::cin >> std::ws, type);
+            std::cout << "Enter first year: ";
+            if (!(std::cin >> minYear)) {
+                std::cin.clear();
+                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                std::cout << std::endl << "Invalid year!" << std::endl;
+                continue;
+            }
+            std::cout << "Enter last year: ";
+            if (!(std::cin >> maxYear)) {
+                std::cin.clear();
+                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                std::cout << std::endl << "Invalid year!" << std::endl;
+                continue;
+            }
+            int count = 0;
+            int* IDs = garage->findByTypeAndYear(type, minYear, maxYear, count);
+            std::cout << std::endl << "Found " << count << " vehicle(s)." << std::endl;
+            for (int i = 0; i < count; i++) {
+                garage->readVehicle(IDs[i]);
+            }
+            delete[] IDs; // the search gives us ownership of the array
+            IDs = nullptr;
+        }
+        else if (choice == 7) { // indexed search
+            VehicleQuery filter;
+            std::cout << std::endl << "Enter make (or - for any): ";
+            std::getline(std::cin >> std::ws, filter.make);
+            std::cout << "Enter model (or - for any): ";
+            std::getline(std::cin >> std::ws, filter.model);
+            std::cout << "Enter type (SEDAN/COUPE/HATCHBACK/MINIVAN/CONVERTIBLE/SUV/PICKUP/UNKNOWN, or - for any): ";
+            std::getline(std::cin >> std::ws, filter.vehicleType);
+            // "-" is easier to type than an empty line, and an empty field is what the query treats as "any"
+            if (filter.make == "-") {
+                filter.make.clear();
+            }
+            if (filter.model == "-") {
+                filter.model.clear();
+            }
+            if (filter.vehicleType == "-") {
+                filter.vehicleType.clear();
+            }
+            std::cout << "Enter first year: ";
+            if (!(std::cin >> filter.minYear)) {
+                std::cin.clear();
+                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                std::cout << std::endl << "Invalid year!" << std::endl;
+                continue;
+            }
+            std::cout << "Enter last year: ";
+            if (!(std::cin >> filter.maxYear)) {
+                std::cin.clear();
+                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                std::cout << std::endl << "Invalid year!" << std::endl;
+                continue;
+            }
+            int count = 0;
+            int* IDs = garage->query(filter, count);
+            std::cout << std::endl << "Found " << count << " vehicle(s)." << std::endl;
+            for (int i = 0; i < count; i++) {
+                garage->readVehicle(IDs[i]);
+            }
+            delete[] IDs;
+            IDs = nullptr;
+        }
+        else if (choice == 8) { // bulk import
+            std::string path;
+            std::cout << std::endl << "Enter the path of the file to import (make,model,type,year per line): ";
+            std::getline(std::cin >> std::ws, path);
+            int imported = 0, rejected = 0;
+            if (garage->importCSV(path, imported, rejected)) {
+                std::cout << std::endl << "Imported " << imported << " vehicle(s), skipped " << rejected << " invalid line(s)." << std::endl;
+            }
+        }
+        else if (choice == 9) { // export
+            std::string path;
+            std::cout << std::endl << "Enter the path of the file to export to: ";
+            std::getline(std::cin >> std::ws, path);
+            if (garage->exportCSV(path)) {
+                std::cout << std::endl << "Vehicles exported successfully!" << std::endl;
+            }
+        }
+        else if (choice == 10) { // benchmark, on its own garage and with its own IDs
+            runConcurrentBenchmark();
+        }
+        else if (choice == 11) {
             std::cout << std::endl << "Goodbye.";
             break;
         }
@@ -366,5 +2448,7 @@ int main()
 
     delete garage; // cleanup
     garage = nullptr;
+    delete journal; // deleting the journal commits anything still pending
+    journal = nullptr;
     return 0;
 }
\ No newline at end of file
@@ -1,275 +1,2990 @@
 #include <iostream>
 #include <string>
+#include <chrono>
+#include <cstring>
+#include <atomic>
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <utility> // std::move, std::forward
+#include <new> // placement new
+#include <cstdlib>
+#include <cstdio> // snprintf
+#ifdef _MSC_VER
+#include <intrin.h> // _BitScanForward
+#endif
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX // otherwise windows.h defines "min"/"max" macros, which break std::min/std::max
+#include <windows.h> // for CreateFileMapping, MapViewOfFile
+#else
+#include <unistd.h> // for close
+#include <fcntl.h> // for open
+#include <sys/mman.h> // for mmap, munmap
+#include <sys/stat.h> // for fstat
+#endif
+
+// every allocation in the program goes through "operator new", so by replacing it we can count them (used by the roster benchmark)
+static std::atomic<long long> allocationCount(0);
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    void* memory = std::malloc(size ? size : 1);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete" // GCC doesn't see that our new/delete are a matching pair
+#endif
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+void operator delete(void* memory, std::size_t) noexcept { // the "sized" version, used by delete when the size is known
+    ::operator delete(memory);
+}
+
+static int highestSetBit(unsigned long long value) { // index of the highest 1 bit (value must not be 0)
+#ifdef _MSC_VER
+    unsigned long index;
+    if (_BitScanReverse(&index, (unsigned long)(value >> 32))) { // the 32-bit version exists on both x86 and x64
+        return (int)index + 32;
+    }
+    _BitScanReverse(&index, (unsigned long)value);
+    return (int)index;
+#elif defined(__GNUC__)
+    return 63 - __builtin_clzll(value);
+#else
+    int index = 0;
+    while (value >>= 1) {
+        index++;
+    }
+    return index;
+#endif
+}
+
+const int STATS_SHARDS = 16; // how many copies of every counter the stats keep, so threads don't share them
+
+int statsShard() { // the copy the calling thread writes to; every new thread takes the next one
+    // when all the threads add to the same atomic, its cache line bounces between the cores on every call,
+    // and that costs more than the work being counted; with their own copy nothing is shared until it's read
+    static std::atomic<int> nextShard(0);
+    thread_local int shard = nextShard.fetch_add(1, std::memory_order_relaxed) % STATS_SHARDS;
+    return shard;
+}
+
+class ShardedCounter { // a counter that many threads can add to at once, summed only when it's read
+private:
+    struct alignas(64) Shard { // one cache line each
+        std::atomic<long long> value;
+    };
+
+    Shard shards[STATS_SHARDS];
+
+public:
+    ShardedCounter() {
+        this->reset();
+    }
+
+    ShardedCounter(const ShardedCounter&) = delete;
+    ShardedCounter& operator=(const ShardedCounter&) = delete;
+
+    void add(long long amount) { // still atomic, since more than STATS_SHARDS threads share the copies
+        this->shards[statsShard()].value.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    long long get() const {
+        long long total = 0;
+        for (int i = 0; i < STATS_SHARDS; i++) {
+            total += this->shards[i].value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    void reset() {
+        for (int i = 0; i < STATS_SHARDS; i++) {
+            this->shards[i].value.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+class LatencyHistogram { // counts how many measurements (in nanoseconds) fall in each range, HDR-histogram style
+    // ranges are "log-linear": every power of two (16-31, 32-63, 64-127, ...) is split into 16 equal buckets,
+    // so every bucket is at most 1/16 (~6%) wide relative to its values, whether they are 50ns or 5s,
+    // and a fixed, small array covers everything from 0 to ~68 seconds; percentiles are read from the counts
+    // every thread records into its own shard (see statsShard), and the shards are added up when they are read
+public:
+    static const int SUB_BITS = 4;
+    static const int SUB_BUCKETS = 1 << SUB_BITS;
+    static const int MAX_BITS = 36; // 2^36 ns, about 68 seconds; anything longer lands in the last bucket
+    static const int BUCKETS = (MAX_BITS - SUB_BITS + 1) * SUB_BUCKETS;
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<long long> counts[BUCKETS];
+        std::atomic<long long> sum;
+        std::atomic<long long> minimum;
+        std::atomic<long long> maximum;
+    };
+
+    Shard shards[STATS_SHARDS];
+
+    static int bucketOf(long long value) {
+        if (value < SUB_BUCKETS) {
+            return value < 0 ? 0 : (int)value; // the first 16 buckets hold a single value each
+        }
+        int exponent = highestSetBit((unsigned long long)value);
+        if (exponent >= MAX_BITS) {
+            return BUCKETS - 1;
+        }
+        int sub = (int)((value >> (exponent - SUB_BITS)) & (SUB_BUCKETS - 1)); // the 4 bits after the highest one
+        return (exponent - SUB_BITS + 1) * SUB_BUCKETS + sub;
+    }
+
+public:
+    static long long bucketStart(int bucket) { // smallest value of a bucket
+        if (bucket < SUB_BUCKETS) {
+            return bucket;
+        }
+        int exponent = bucket / SUB_BUCKETS + SUB_BITS - 1;
+        return (long long)(SUB_BUCKETS + bucket % SUB_BUCKETS) << (exponent - SUB_BITS);
+    }
+
+    static long long bucketEnd(int bucket) { // largest value of a bucket
+        return bucket + 1 < BUCKETS ? bucketStart(bucket + 1) - 1 : bucketStart(bucket);
+    }
+
+    LatencyHistogram() {
+        this->reset();
+    }
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void reset() { // not atomic as a whole, so don't reset while other threads are recording
+        for (int s = 0; s < STATS_SHARDS; s++) {
+            Shard& shard = this->shards[s];
+            for (int i = 0; i < BUCKETS; i++) {
+                shard.counts[i].store(0, std::memory_order_relaxed);
+            }
+            shard.sum.store(0, std::memory_order_relaxed);
+            shard.minimum.store(0x7FFFFFFFFFFFFFFFll, std::memory_order_relaxed);
+            shard.maximum.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void record(long long nanoseconds) {
+        Shard& shard = this->shards[statsShard()];
+        shard.counts[bucketOf(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+        shard.sum.fetch_add(nanoseconds, std::memory_order_relaxed);
+        long long current = shard.minimum.load(std::memory_order_relaxed);
+        while (nanoseconds < current && !shard.minimum.compare_exchange_weak(current, nanoseconds, std::memory_order_relaxed)) {
+        }
+        current = shard.maximum.load(std::memory_order_relaxed);
+        while (nanoseconds > current && !shard.maximum.compare_exchange_weak(current, nanoseconds, std::memory_order_relaxed)) {
+        }
+    }
+
+    long long getCount() const {
+        long long count = 0;
+        for (int i = 0; i < BUCKETS; i++) {
+            count += this->getCount(i);
+        }
+        return count;
+    }
+
+    long long getCount(int bucket) const {
+        long long count = 0;
+        for (int s = 0; s < STATS_SHARDS; s++) {
+            count += this->shards[s].counts[bucket].load(std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+    long long getMin() const {
+        long long minimum = 0x7FFFFFFFFFFFFFFFll;
+        for (int s = 0; s < STATS_SHARDS; s++) {
+            minimum = std::min(minimum, this->shards[s].minimum.load(std::memory_order_relaxed));
+        }
+        return this->getCount() ? minimum : 0;
+    }
+
+    long long getMax() const {
+        long long maximum = 0;
+        for (int s = 0; s < STATS_SHARDS; s++) {
+            maximum = std::max(maximum, this->shards[s].maximum.load(std::memory_order_relaxed));
+        }
+        return maximum;
+    }
+
+    double getMean() const {
+        long long count = this->getCount();
+        long long sum = 0;
+        for (int s = 0; s < STATS_SHARDS; s++) {
+            sum += this->shards[s].sum.load(std::memory_order_relaxed);
+        }
+        return count ? (double)sum / count : 0.0;
+    }
+
+    long long percentile(double p) const { // the value below which p% of the measurements fall (the end of its bucket)
+        long long count = this->getCount();
+        if (!count) {
+            return 0;
+        }
+        long long wanted = (long long)(p / 100.0 * count + 0.5);
+        if (wanted < 1) {
+            wanted = 1;
+        }
+        long long seen = 0;
+        for (int i = 0; i < BUCKETS; i++) {
+            seen += this->getCount(i);
+            if (seen >= wanted) {
+                return std::min(bucketEnd(i), this->getMax());
+            }
+        }
+        return this->getMax();
+    }
+};
+
+class QueryStats { // latency + outcome of one kind of scheduling query
+private:
+    LatencyHistogram latency;
+    ShardedCounter hits; // queries which found a doctor
+    ShardedCounter misses;
+    ShardedCounter candidates; // doctors looked at to answer them
+
+public:
+    QueryStats() {}
+
+    QueryStats(const QueryStats&) = delete;
+    QueryStats& operator=(const QueryStats&) = delete;
+
+    void record(std::chrono::steady_clock::time_point start, bool hit, long long examined);
+
+    void reset() {
+        this->latency.reset();
+        this->hits.reset();
+        this->misses.reset();
+        this->candidates.reset();
+    }
+
+    void writeJson(std::ostream& out, const char* indent) const {
+        long long hitCount = this->hits.get();
+        long long missCount = this->misses.get();
+        out << "{" << std::endl;
+        out << indent << "  \"count\": " << this->latency.getCount() << "," << std::endl;
+        out << indent << "  \"hits\": " << hitCount << "," << std::endl;
+        out << indent << "  \"misses\": " << missCount << "," << std::endl;
+        out << indent << "  \"hitRate\": " << (hitCount + missCount ? (double)hitCount / (hitCount + missCount) : 0.0) << "," << std::endl;
+        out << indent << "  \"candidatesExamined\": " << this->candidates.get() << "," << std::endl;
+        out << indent << "  \"latencyNs\": { \"min\": " << this->latency.getMin() << ", \"mean\": " << (long long)this->latency.getMean()
+            << ", \"p50\": " << this->latency.percentile(50) << ", \"p90\": " << this->latency.percentile(90) << ", \"p99\": "
+            << this->latency.percentile(99) << ", \"p99.9\": " << this->latency.percentile(99.9) << ", \"max\": " << this->latency.getMax()
+            << " }," << std::endl;
+        out << indent << "  \"histogram\": ["; // only the buckets which have something, as [first ns, last ns, count]
+        bool first = true;
+        for (int i = 0; i < LatencyHistogram::BUCKETS; i++) {
+            long long count = this->latency.getCount(i);
+            if (count) {
+                out << (first ? "" : ", ") << "[" << LatencyHistogram::bucketStart(i) << ", " << LatencyHistogram::bucketEnd(i) << ", " << count << "]";
+                first = false;
+            }
+        }
+        out << "]" << std::endl << indent << "}";
+    }
+};
+
+class SchedulingStats { // everything we measure on the scheduling path, shared by the whole program
+    // reading the clock costs some tens of nanoseconds, about as much as an index lookup itself, so it can be switched off
+private:
+    std::atomic<bool> enabled;
+
+    SchedulingStats() : enabled(true) {}
+
+public:
+    QueryStats lookups; // SchedulingIndex::findAll (including the ones made by bookings)
+    QueryStats bookings; // BookingStore::book
+    QueryStats freeSearches; // ScheduleTree::findFree
+    QueryStats batches; // BatchScheduler::solve, one sample per batch (hits/misses are per request)
+    ShardedCounter specialtyChecks; // Doctor::hasSpecialty calls (the linear scans)
+    ShardedCounter availabilityChecks; // Doctor::worksAt/isFreeDuring calls
+
+    SchedulingStats(const SchedulingStats&) = delete;
+    SchedulingStats& operator=(const SchedulingStats&) = delete;
+
+    static SchedulingStats& instance() {
+        static SchedulingStats stats;
+        return stats;
+    }
+
+    bool isEnabled() const {
+        return this->enabled.load(std::memory_order_relaxed);
+    }
+
+    void setEnabled(bool on) {
+        this->enabled.store(on, std::memory_order_relaxed);
+    }
+
+    static std::chrono::steady_clock::time_point start() { // the time a query starts (not read when disabled)
+        return instance().isEnabled() ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+    }
+
+    void reset() {
+        this->lookups.reset();
+        this->bookings.reset();
+        this->freeSearches.reset();
+        this->batches.reset();
+        this->specialtyChecks.reset();
+        this->availabilityChecks.reset();
+    }
+
+    void writeJson(std::ostream& out, int doctorCount) const {
+        out << "{" << std::endl;
+        out << "  \"enabled\": " << (this->isEnabled() ? "true" : "false") << "," << std::endl;
+        out << "  \"doctors\": " << doctorCount << "," << std::endl;
+        out << "  \"specialtyChecks\": " << this->specialtyChecks.get() << "," << std::endl;
+        out << "  \"availabilityChecks\": " << this->availabilityChecks.get() << "," << std::endl;
+        out << "  \"queries\": {" << std::endl;
+        out << "    \"indexLookup\": ";
+        this->lookups.writeJson(out, "    ");
+        out << "," << std::endl << "    \"booking\": ";
+        this->bookings.writeJson(out, "    ");
+        out << "," << std::endl << "    \"freeSearch\": ";
+        this->freeSearches.writeJson(out, "    ");
+        out << "," << std::endl << "    \"batch\": ";
+        this->batches.writeJson(out, "    ");
+        out << std::endl << "  }" << std::endl << "}" << std::endl;
+    }
+};
+
+void QueryStats::record(std::chrono::steady_clock::time_point start, bool hit, long long examined) { // defined here, since it needs SchedulingStats
+    if (!SchedulingStats::instance().isEnabled()) {
+        return;
+    }
+    this->latency.record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    (hit ? this->hits : this->misses).add(1);
+    this->candidates.add(examined);
+}
+
+class SpecialtyRegistry { // every specialty name is stored once here, and doctors only keep its id (0..63)
+    // with at most 64 ids, a doctor's specialties fit in the bits of one 64-bit number, so "does this doctor have X"
+    // becomes a single AND instead of comparing strings, and nothing needs to be allocated per doctor
+    // ids are handed out in the order the names are first seen, and never change
+    // beware: adding names is not thread-safe, so all the doctors should be created before threads start looking names up
+public:
+    static const int MAX_SPECIALTIES = 64;
+
+private:
+    static const int SLOT_COUNT = 128; // hash table twice as big as the most names we can have, so lookups stay short
+    std::string names[MAX_SPECIALTIES];
+    int count;
+    int slots[SLOT_COUNT]; // ids (-1 = empty), placed by the hash of their name
+
+    SpecialtyRegistry() : count(0) {
+        for (int i = 0; i < SLOT_COUNT; i++) {
+            this->slots[i] = -1;
+        }
+    }
+
+    static unsigned int hashText(const std::string& text) { // FNV-1a
+        unsigned int h = 2166136261u;
+        for (size_t i = 0; i < text.length(); i++) {
+            h ^= (unsigned char)text[i];
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    int findSlot(const std::string& name) const { // slot holding the name, or the empty slot where it would go
+        int pos = (int)(hashText(name) & (SLOT_COUNT - 1));
+        while (this->slots[pos] != -1 && this->names[this->slots[pos]] != name) {
+            pos = (pos + 1) & (SLOT_COUNT - 1);
+        }
+        return pos;
+    }
+
+public:
+    SpecialtyRegistry(const SpecialtyRegistry&) = delete;
+    SpecialtyRegistry& operator=(const SpecialtyRegistry&) = delete;
+
+    static SpecialtyRegistry& instance() { // the one registry shared by all doctors (created the first time it's needed)
+        static SpecialtyRegistry registry;
+        return registry;
+    }
+
+    int find(const std::string& name) const { // -1 if the name was never added
+        return this->slots[this->findSlot(name)];
+    }
+
+    int add(const std::string& name) { // returns the name's id, giving it a new one if needed (-1 if there is no room left)
+        int pos = this->findSlot(name);
+        if (this->slots[pos] != -1) {
+            return this->slots[pos];
+        }
+        if (this->count == MAX_SPECIALTIES) {
+            std::cout << "Cannot have more than " << MAX_SPECIALTIES << " different specialties!" << std::endl;
+            return -1;
+        }
+        this->names[this->count] = name;
+        this->slots[pos] = this->count;
+        return this->count++;
+    }
+
+    const std::string& getName(int id) const {
+        return this->names[id];
+    }
+
+    int getCount() const {
+        return this->count;
+    }
+};
+
+class SpecialtySpan { // a read-only view of a doctor's specialty ids: it points into the doctor, and copies nothing
+    // it is only valid while the doctor it came from exists and its specialties aren't changed
+private:
+    const unsigned char* ids;
+    int count;
+
+public:
+    SpecialtySpan(const unsigned char* ids, int count) : ids(ids), count(count) {}
+
+    int size() const {
+        return this->count;
+    }
+
+    int operator[](int i) const { // id of the i-th specialty
+        return this->ids[i];
+    }
+
+    const std::string& name(int i) const {
+        return SpecialtyRegistry::instance().getName(this->ids[i]);
+    }
+
+    const unsigned char* begin() const { // begin/end let us write "for (int id : doctor.getSpecialties())"
+        return this->ids;
+    }
+
+    const unsigned char* end() const {
+        return this->ids + this->count;
+    }
+};
+
+const int MINUTES_PER_WEEK = 7 * 24 * 60;
+
+int minuteOfWeek(int day, int hour, int minute) { // day 1 (Monday) .. 7, so Monday 00:00 is 0 and Sunday 23:59 is 10079
+    return ((day - 1) * 24 + hour) * 60 + minute;
+}
+
+class IntervalList { // sorted, non-overlapping [start, end) intervals of minutes of the week
+    // most doctors have one or two shifts, so the first two intervals are kept inside the object itself,
+    // and only longer lists move to the heap (this is called a "small buffer optimization")
+private:
+    static const int INLINE_INTERVALS = 2;
+    int inlineData[INLINE_INTERVALS * 2];
+    int* data; // data[2 * i] = start of interval i, data[2 * i + 1] = its end; points either to inlineData or to a heap array
+    int count;
+    int capacity;
+
+    bool isInline() const {
+        return this->data == this->inlineData;
+    }
+
+    void grow() {
+        int* tmp = new int[this->capacity * 4];
+        memcpy(tmp, this->data, sizeof(int) * this->count * 2);
+        if (!this->isInline()) {
+            delete[] this->data;
+        }
+        this->data = tmp;
+        this->capacity *= 2;
+    }
+
+    void copyFrom(const IntervalList& other) { // we must be empty and inline when this is called
+        if (other.count > INLINE_INTERVALS) {
+            this->data = new int[other.count * 2];
+            this->capacity = other.count;
+        }
+        memcpy(this->data, other.data, sizeof(int) * other.count * 2);
+        this->count = other.count;
+    }
+
+    void stealFrom(IntervalList& other) { // same, but takes other's heap array instead of copying it
+        if (other.isInline()) {
+            memcpy(this->inlineData, other.inlineData, sizeof(int) * other.count * 2);
+        }
+        else {
+            this->data = other.data;
+            this->capacity = other.capacity;
+            other.data = other.inlineData;
+            other.capacity = INLINE_INTERVALS;
+        }
+        this->count = other.count;
+        other.count = 0;
+    }
+
+    void release() {
+        if (!this->isInline()) {
+            delete[] this->data;
+        }
+        this->data = this->inlineData;
+        this->count = 0;
+        this->capacity = INLINE_INTERVALS;
+    }
+
+public:
+    IntervalList() : data(inlineData), count(0), capacity(INLINE_INTERVALS) {}
+
+    IntervalList(const IntervalList& other) : data(inlineData), count(0), capacity(INLINE_INTERVALS) {
+        this->copyFrom(other);
+    }
+
+    IntervalList(IntervalList&& other) noexcept : data(inlineData), count(0), capacity(INLINE_INTERVALS) {
+        this->stealFrom(other);
+    }
+
+    IntervalList& operator=(const IntervalList& other) {
+        if (this != &other) {
+            this->release();
+            this->copyFrom(other);
+        }
+        return *this;
+    }
+
+    IntervalList& operator=(IntervalList&& other) noexcept {
+        if (this != &other) {
+            this->release();
+            this->stealFrom(other);
+        }
+        return *this;
+    }
+
+    ~IntervalList() {
+        this->release();
+    }
+
+    void clear() {
+        this->release();
+    }
+
+    void add(int start, int end) { // adds [start, end), merging it with the intervals it overlaps or touches
+        if (start >= end) {
+            return;
+        }
+        int first = 0; // first interval ending at or after "start" (everything before it stays untouched)
+        while (first < this->count && this->data[2 * first + 1] < start) {
+            first++;
+        }
+        int last = first; // intervals first..last-1 overlap or touch the new one, so they get merged into it
+        while (last < this->count && this->data[2 * last] <= end) {
+            start = std::min(start, this->data[2 * last]);
+            end = std::max(end, this->data[2 * last + 1]);
+            last++;
+        }
+        if (first == last && this->count == this->capacity) {
+            this->grow();
+        }
+        int removed = last - first - 1; // how many slots we free (-1 if we need one more)
+        if (removed != 0) {
+            memmove(this->data + 2 * (last - removed), this->data + 2 * last, sizeof(int) * 2 * (this->count - last));
+            this->count -= removed;
+        }
+        this->data[2 * first] = start;
+        this->data[2 * first + 1] = end;
+    }
+
+    void subtract(const IntervalList& other) { // removes every minute covered by "other"
+        IntervalList result;
+        int j = 0;
+        for (int i = 0; i < this->count; i++) {
+            int start = this->data[2 * i];
+            int end = this->data[2 * i + 1];
+            while (j < other.count && other.data[2 * j + 1] <= start) {
+                j++; // ends before this interval, so it ends before every later one too
+            }
+            for (int k = j; k < other.count && other.data[2 * k] < end; k++) {
+                if (other.data[2 * k] > start) {
+                    result.add(start, other.data[2 * k]);
+                }
+                start = std::max(start, other.data[2 * k + 1]);
+            }
+            if (start < end) {
+                result.add(start, end);
+            }
+        }
+        *this = std::move(result);
+    }
+
+    bool covers(int start, int end) const { // is all of [start, end) inside one of our intervals (binary search)
+        int low = 0;
+        int high = this->count; // find the last interval starting at or before "start"
+        while (low < high) {
+            int middle = (low + high) / 2;
+            if (this->data[2 * middle] <= start) {
+                low = middle + 1;
+            }
+            else {
+                high = middle;
+            }
+        }
+        return low > 0 && this->data[2 * (low - 1) + 1] >= end;
+    }
+
+    int getCount() const {
+        return this->count;
+    }
+
+    int getStart(int i) const {
+        return this->data[2 * i];
+    }
+
+    int getEnd(int i) const {
+        return this->data[2 * i + 1];
+    }
+
+    void print() const {
+        static const char* days[] = { "Mon", "Tue", "Wed", "Thu", "Fri", "Sat", "Sun" };
+        if (!this->count) {
+            std::cout << "(None)";
+        }
+        for (int i = 0; i < this->count; i++) {
+            int start = this->data[2 * i];
+            int end = this->data[2 * i + 1];
+            char text[32];
+            snprintf(text, sizeof(text), "%s %02d:%02d-%s%02d:%02d", days[start / 1440], start % 1440 / 60, start % 60,
+                end / 1440 != start / 1440 ? days[(end - 1) / 1440] : "", end / 1440 != start / 1440 && end % 1440 == 0 ? 24 : end % 1440 / 60, end % 60);
+            std::cout << text;
+            if (i < this->count - 1) {
+                std::cout << ", ";
+            }
+        }
+    }
+};
 
 class Doctor {
+public:
+    static const int MAX_SPECIALTIES = 8; // per doctor
+
 private:
     std::string name;
-    std::string * specialties;
+    unsigned long long specialtyMask; // bit i is set if the doctor has the specialty with id i
+    unsigned char specialtyIds[MAX_SPECIALTIES]; // the same ids, in the order they were given (for printing), stored inside the object
     int specialtyCount;
     int preferredWorkingDay;
     int workingHoursStart;
     int workingHoursEnd;
+    // on top of the preferred day and hours, a doctor can have extra shifts and time off (holidays), at minute precision
+    IntervalList extraShifts;
+    IntervalList timeOff;
+    IntervalList available; // (preferred day/hours + extra shifts) - time off, kept up to date by every setter
+
+    void updateAvailability() {
+        this->available = this->extraShifts;
+        // "hours 8-16" means the doctor works through the hour starting at 16 (as worksAt always did), so until 17:00
+        this->available.add(minuteOfWeek(this->preferredWorkingDay, this->workingHoursStart, 0),
+            minuteOfWeek(this->preferredWorkingDay, this->workingHoursEnd, 0) + 60);
+        this->available.subtract(this->timeOff);
+    }
+
+    static bool validInterval(int startMinute, int endMinute) {
+        if (startMinute < 0 || endMinute > MINUTES_PER_WEEK || startMinute >= endMinute) {
+            std::cout << "Interval must be inside the week (0-" << MINUTES_PER_WEEK << " minutes) and not empty!" << std::endl;
+            return false;
+        }
+        return true;
+    }
 
 public:
     Doctor() { // default constructor
         this->name = "";
-        this->specialties = nullptr;
+        this->specialtyMask = 0;
         this->specialtyCount = 0;
         this->preferredWorkingDay = 1;
         this->workingHoursStart = 8;
         this->workingHoursEnd = 16;
+        this->updateAvailability();
+    }
+
+    Doctor(std::string n, const std::string* specs, int count, int day, int startHour, int endHour): 
+        specialtyMask(0), specialtyCount(0), workingHoursStart(0), workingHoursEnd(23) { // parametrized constructor
+        // since we use setters and do validations on the parameters there with our parameters
+        // we have to give them some default values (so as to avoid comparisons with uninitialized memory)
+        // the name is taken by value: a temporary (like "Doctor("John", ...)") is moved into "n" without copying its characters,
+        // and we then move it again into our attribute, so the only copy ever made is when the caller passes a named string
+        this->setName(std::move(n));
+        this->setSpecialties(specs, count); // use setters to avoid code reuse
+        this->setPreferredWorkingDay(day);
+        this->setWorkingHoursStart(startHour);
+        this->setWorkingHoursEnd(endHour);
+    }
+
+    Doctor(std::string n, const unsigned char* specialtyIds, int count, int day, int startHour, int endHour) :
+        specialtyMask(0), specialtyCount(0), workingHoursStart(0), workingHoursEnd(23) { // same, with specialties given as registry ids
+        this->setName(std::move(n));
+        this->setSpecialtyIds(specialtyIds, count);
+        this->setPreferredWorkingDay(day);
+        this->setWorkingHoursStart(startHour);
+        this->setWorkingHoursEnd(endHour);
+    }
+
+    Doctor(const Doctor& other) { // copy constructor
+        // no need to validate other values, since we have an already constructed object which passed validations
+        // this one, being also a constructor, has the class's name
+        // it tells the program how we can initialize an object from an already existing one, rather than a list of parameters now
+        // the copy ctor is called explicitly when doing stuff like:
+        // "Doctor a; Doctor b(a);"
+        // or "Doctor b = Doctor(a);" (even though this one uses the assignment operator, since "b" is not already defined
+        // it does something called copy-initialization, and is equivalent to "Doctor b(a);", and no assignment is done, just copy)
+        // if "b" was already defined, doing "b = a" would result in using the assignment operator, which we haven't learned yet
+        // or implicitly, when passing/returning objects as value rather than reference
+        // by default, the copy ctor would do a bitwise copy of all of our attributes
+        // and therefore would shallow-copy any dynamic arrays
+        // hence, it is imperative that we define it when working with dynamic memory 
+        // (more on that later, when we learn operators and learn about the rule of three)
+        // our specialties used to be such a dynamic array; now they are ids kept inside the object, so copying them is cheap and safe
+
+        // it being a special function, and operating on objects of our type, the copy constructor can access private attributes
+        // without any special designation (more on that later, when we'll learn about friend classes)
+        this->name = other.name;
+        this->specialtyMask = other.specialtyMask;
+        this->specialtyCount = other.specialtyCount;
+        memcpy(this->specialtyIds, other.specialtyIds, other.specialtyCount);
+
+        this->preferredWorkingDay = other.preferredWorkingDay;
+        this->workingHoursStart = other.workingHoursStart;
+        this->workingHoursEnd = other.workingHoursEnd;
+        this->extraShifts = other.extraShifts;
+        this->timeOff = other.timeOff;
+        this->available = other.available;
+    }
+
+    Doctor(Doctor&& other) noexcept : name(std::move(other.name)), extraShifts(std::move(other.extraShifts)),
+        timeOff(std::move(other.timeOff)), available(std::move(other.available)) { // move constructor
+        // "&&" binds to objects about to disappear (temporaries, or ones passed through std::move), so instead of copying
+        // we can steal their resources: moving a std::string just takes its buffer pointer, and leaves "other" empty
+        // it is noexcept (it cannot throw), which containers require before they move rather than copy when they grow
+        this->specialtyMask = other.specialtyMask;
+        this->specialtyCount = other.specialtyCount;
+        memcpy(this->specialtyIds, other.specialtyIds, other.specialtyCount);
+        this->preferredWorkingDay = other.preferredWorkingDay;
+        this->workingHoursStart = other.workingHoursStart;
+        this->workingHoursEnd = other.workingHoursEnd;
+    }
+
+    Doctor& operator=(const Doctor& other) { // copy assignment, used by "b = a" when "b" already exists
+        // together with the copy constructor and the destructor, this is the "rule of three"
+        if (this != &other) { // "a = a" must not break anything
+            this->name = other.name;
+            this->specialtyMask = other.specialtyMask;
+            this->specialtyCount = other.specialtyCount;
+            memcpy(this->specialtyIds, other.specialtyIds, other.specialtyCount);
+            this->preferredWorkingDay = other.preferredWorkingDay;
+            this->workingHoursStart = other.workingHoursStart;
+            this->workingHoursEnd = other.workingHoursEnd;
+            this->extraShifts = other.extraShifts;
+            this->timeOff = other.timeOff;
+            this->available = other.available;
+        }
+        return *this; // returning ourselves allows chaining, like "c = b = a"
+    }
+
+    Doctor& operator=(Doctor&& other) noexcept { // move assignment, used by "b = Doctor(...)" or "b = std::move(a)"
+        // with the move constructor, this makes the "rule of five"
+        if (this != &other) {
+            this->name = std::move(other.name);
+            this->specialtyMask = other.specialtyMask;
+            this->specialtyCount = other.specialtyCount;
+            memcpy(this->specialtyIds, other.specialtyIds, other.specialtyCount);
+            this->preferredWorkingDay = other.preferredWorkingDay;
+            this->workingHoursStart = other.workingHoursStart;
+            this->workingHoursEnd = other.workingHoursEnd;
+            this->extraShifts = std::move(other.extraShifts);
+            this->timeOff = std::move(other.timeOff);
+            this->available = std::move(other.available);
+        }
+        return *this;
+    }
+
+    ~Doctor() {
+        // nothing to free: the specialty names belong to the registry, and std::string and IntervalList clean up after themselves
+    }
+
+    std::string getName() const {
+        return this->name;
+    }
+
+    SpecialtySpan getSpecialties() const { // a view of our ids, instead of a deep copy the caller would have to delete
+        return SpecialtySpan(this->specialtyIds, this->specialtyCount);
+    }
+
+    unsigned long long getSpecialtyMask() const {
+        return this->specialtyMask;
+    }
+
+    int getSpecialtyCount() const {
+        return this->specialtyCount;
+    }
+
+    int getPreferredWorkingDay() const {
+        return this->preferredWorkingDay;
+    }
+
+    int getWorkingHoursStart() const {
+        return this->workingHoursStart;
+    }
+
+    int getWorkingHoursEnd() const {
+        return this->workingHoursEnd;
+    }
+
+    const IntervalList& getExtraShifts() const {
+        return this->extraShifts;
+    }
+
+    const IntervalList& getTimeOff() const {
+        return this->timeOff;
+    }
+
+    const IntervalList& getAvailability() const { // the minutes of the week the doctor works (read-only, so returning a reference is safe)
+        return this->available;
+    }
+
+    void setName(const std::string& n) {
+        if (n.length() >= 3) {
+            this->name = n;
+        }
+        else {
+            std::cout << "Name length cannot be less than 3!" << std::endl;
+            this->name = ""; // give a default value
+        }
+        
+    }
+
+    void setName(std::string&& n) { // same, for temporaries: we take over their characters instead of copying them
+        if (n.length() >= 3) {
+            this->name = std::move(n);
+        }
+        else {
+            std::cout << "Name length cannot be less than 3!" << std::endl;
+            this->name = "";
+        }
+    }
+
+    void setSpecialties(const std::string* specs, int count) {
+        this->specialtyMask = 0; // clear before adding the new ones
+        this->specialtyCount = 0;
+
+        if (count > 0 && specs != nullptr) {
+            for (int i = 0; i < count; i++) {
+                int id = SpecialtyRegistry::instance().add(specs[i]); // the registry keeps the name, we only keep its id
+                if (id == -1 || (this->specialtyMask >> id) & 1ull) { // no room in the registry, or given twice
+                    continue;
+                }
+                if (this->specialtyCount == MAX_SPECIALTIES) {
+                    std::cout << "A doctor cannot have more than " << MAX_SPECIALTIES << " specialties!" << std::endl;
+                    break;
+                }
+                this->specialtyMask |= 1ull << id;
+                this->specialtyIds[this->specialtyCount++] = (unsigned char)id;
+            }
+        }
+        else {
+            std::cout << "Count cannot be less than 1 or the array cannot be null!" << std::endl;
+        }
+    }
+
+    void setSpecialtyIds(const unsigned char* ids, int count) { // same, with ids the registry already gave out (no name lookups)
+        this->specialtyMask = 0;
+        this->specialtyCount = 0;
+        if (count <= 0 || ids == nullptr) {
+            std::cout << "Count cannot be less than 1 or the array cannot be null!" << std::endl;
+            return;
+        }
+        for (int i = 0; i < count; i++) {
+            if (ids[i] >= SpecialtyRegistry::instance().getCount()) {
+                std::cout << "Unknown specialty id " << (int)ids[i] << "!" << std::endl;
+                continue;
+            }
+            if ((this->specialtyMask >> ids[i]) & 1ull) {
+                continue;
+            }
+            if (this->specialtyCount == MAX_SPECIALTIES) {
+                std::cout << "A doctor cannot have more than " << MAX_SPECIALTIES << " specialties!" << std::endl;
+                break;
+            }
+            this->specialtyMask |= 1ull << ids[i];
+            this->specialtyIds[this->specialtyCount++] = ids[i];
+        }
+    }
+
+    void setPreferredWorkingDay(int d) {
+        if (d < 1) {
+            std::cout << "Day cannot be less than 1 (Monday)!" << std::endl;
+            d = 1;
+        }
+        if (d > 7) {
+            std::cout << "Day cannot be bigger than 7 (Sunday)!" << std::endl;
+            d = 7;
+        }
+        this->preferredWorkingDay = d;
+        this->updateAvailability();
+    }
+
+    void setWorkingHoursStart(int h) {
+        if (h < 0) {
+            std::cout << "Hour cannot be less than 0!" << std::endl;
+            h = 0;
+        }
+        if (h > 23) {
+            std::cout << "Hour cannot be bigger than 23!" << std::endl;
+            h = 23;
+        }
+        if (h >= this->workingHoursEnd) {
+            h = this->workingHoursEnd - 1;
+            std::cout << "Start hour cannot be bigger than or equal to the end hour!" << std::endl;
+        }
+        this->workingHoursStart = h;
+        this->updateAvailability();
+    }
+
+    void setWorkingHoursEnd(int h) {
+        if (h < 0) {
+            std::cout << "Hour cannot be less than 0!" << std::endl;
+            h = 0;
+        }
+        if (h > 23) {
+            std::cout << "Hour cannot be bigger than 23!" << std::endl;
+            h = 23;
+        }
+        if (h <= this->workingHoursStart) {
+            h = this->workingHoursStart + 1;
+            std::cout << "End hour cannot be smaller than or equal to the start hour!" << std::endl;
+        }
+        this->workingHoursEnd = h;
+        this->updateAvailability();
+    }
+
+    void addShift(int startMinute, int endMinute) { // minutes of the week, see minuteOfWeek
+        if (validInterval(startMinute, endMinute)) {
+            this->extraShifts.add(startMinute, endMinute);
+            this->updateAvailability();
+        }
+    }
+
+    void addTimeOff(int startMinute, int endMinute) { // a holiday or any other absence, which wins over the shifts
+        if (validInterval(startMinute, endMinute)) {
+            this->timeOff.add(startMinute, endMinute);
+            this->updateAvailability();
+        }
+    }
+
+    void clearTimeOff() {
+        this->timeOff.clear();
+        this->updateAvailability();
+    }
+
+    bool hasSpecialty(int id) const {
+        if (SchedulingStats::instance().isEnabled()) {
+            SchedulingStats::instance().specialtyChecks.add(1);
+        }
+        return id >= 0 && id < SpecialtyRegistry::MAX_SPECIALTIES && ((this->specialtyMask >> id) & 1ull);
+    }
+
+    bool hasSpecialty(const std::string& s) const {
+        return this->hasSpecialty(SpecialtyRegistry::instance().find(s)); // one lookup in the registry, then a single AND
+    }
+
+    bool isFreeDuring(int startMinute, int endMinute) const { // works the whole time from startMinute to endMinute
+        if (SchedulingStats::instance().isEnabled()) {
+            SchedulingStats::instance().availabilityChecks.add(1);
+        }
+        return this->available.covers(startMinute, endMinute);
+    }
+
+    bool worksAt(int day, int hour) const { // works the whole hour
+        if (day < 1 || day > 7 || hour < 0 || hour > 23) {
+            return false;
+        }
+        return this->isFreeDuring(minuteOfWeek(day, hour, 0), minuteOfWeek(day, hour, 0) + 60);
+    }
+
+    void print() const {
+        std::cout << "Doctor: " << this->name << std::endl;
+        std::cout << "Specialties: ";
+        if (this->specialtyCount) {
+            for (int i = 0; i < this->specialtyCount; i++) {
+                std::cout << SpecialtyRegistry::instance().getName(this->specialtyIds[i]);
+                if (i < this->specialtyCount - 1) {
+                    std::cout << ", ";
+                }
+            }
+        }
+        else {
+            std::cout << "(None)";
+        }
+        std::cout << std::endl << "Preferred day: " << this->preferredWorkingDay << std::endl;
+        std::cout << "Working hours: " << this->workingHoursStart << "-" << this->workingHoursEnd << std::endl;
+        if (this->extraShifts.getCount() || this->timeOff.getCount()) {
+            std::cout << "Available: ";
+            this->available.print();
+            std::cout << std::endl;
+        }
+    }
+};
+
+class DoctorRoster { // a growable array of doctors, which constructs each one directly in its final place
+    // "new Doctor[n]" would first build n default doctors and then overwrite them; instead we allocate raw memory
+    // and only construct a doctor in a slot when it's added (with placement new), and when the array has to grow,
+    // the doctors are moved (not copied) into the new memory
+private:
+    Doctor* doctors; // only the first "size" slots hold constructed doctors, the rest is raw memory
+    int size;
+    int capacity;
+
+    static Doctor* allocate(int capacity) { // memory for "capacity" doctors, without constructing any
+        return static_cast<Doctor*>(::operator new(sizeof(Doctor) * capacity));
+    }
+
+    void moveInto(Doctor* target) { // moves our doctors into "target" and frees our memory
+        for (int i = 0; i < this->size; i++) {
+            new (target + i) Doctor(std::move(this->doctors[i]));
+            this->doctors[i].~Doctor(); // memory from ::operator new is freed by hand, so destructors have to be called by hand too
+        }
+        ::operator delete(this->doctors);
+        this->doctors = target;
+    }
+
+public:
+    DoctorRoster() : doctors(nullptr), size(0), capacity(0) {}
+
+    DoctorRoster(const DoctorRoster&) = delete;
+    DoctorRoster& operator=(const DoctorRoster&) = delete;
+
+    ~DoctorRoster() {
+        for (int i = 0; i < this->size; i++) {
+            this->doctors[i].~Doctor();
+        }
+        ::operator delete(this->doctors);
+        this->doctors = nullptr;
+    }
+
+    void reserve(int newCapacity) { // make room up front, when we know how many doctors are coming
+        if (newCapacity > this->capacity) {
+            this->moveInto(allocate(newCapacity));
+            this->capacity = newCapacity;
+        }
+    }
+
+    // "Args&&... args" accepts any number of arguments of any type, and std::forward passes each one on exactly as it came
+    // (temporaries stay temporaries, so they can be moved), to whichever Doctor constructor matches them
+    template <typename... Args>
+    Doctor& emplace(Args&&... args) {
+        if (this->size == this->capacity) {
+            // the new doctor is built in the new memory before the old doctors are moved out,
+            // so arguments referring to one of our own doctors (like "emplace(roster[0])") are still valid while we use them
+            int newCapacity = this->capacity ? this->capacity * 2 : 16;
+            Doctor* grown = allocate(newCapacity);
+            new (grown + this->size) Doctor(std::forward<Args>(args)...);
+            this->moveInto(grown);
+            this->capacity = newCapacity;
+        }
+        else {
+            new (this->doctors + this->size) Doctor(std::forward<Args>(args)...);
+        }
+        return this->doctors[this->size++];
+    }
+
+    Doctor& operator[](int i) {
+        return this->doctors[i];
+    }
+
+    const Doctor& operator[](int i) const {
+        return this->doctors[i];
+    }
+
+    const Doctor* getDoctors() const {
+        return this->doctors;
+    }
+
+    void clear() { // removes every doctor, but keeps the memory for the next ones
+        for (int i = 0; i < this->size; i++) {
+            this->doctors[i].~Doctor();
+        }
+        this->size = 0;
+    }
+
+    int getSize() const {
+        return this->size;
+    }
+};
+
+class DoctorArray { // lets the indexes read a plain Doctor array the same way as a roster snapshot (see SchedulingIndex::buildFrom)
+private:
+    const Doctor* doctors;
+
+public:
+    explicit DoctorArray(const Doctor* doctors) : doctors(doctors) {}
+
+    unsigned long long getSpecialtyMask(int d) const {
+        return this->doctors[d].getSpecialtyMask();
+    }
+
+    int getSpecialtyIds(int d, unsigned char* ids) const { // copies the doctor's ids into "ids", returns how many
+        SpecialtySpan specialties = this->doctors[d].getSpecialties();
+        for (int i = 0; i < specialties.size(); i++) {
+            ids[i] = (unsigned char)specialties[i];
+        }
+        return specialties.size();
+    }
+
+    const IntervalList& getAvailability(int d, IntervalList&) const { // a doctor already keeps it, so the scratch list isn't needed
+        return this->doctors[d].getAvailability();
+    }
+};
+
+class MappedFile { // read-only memory mapping of a whole file
+    // the OS maps the file into our address space and only reads the pages we actually touch, so opening even a huge file
+    // costs next to nothing, and nothing is copied into buffers of ours
+private:
+    const char* data;
+    long long size;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#else
+    int descriptor;
+#endif
+
+public:
+#ifdef _WIN32
+    MappedFile() : data(nullptr), size(0), file(INVALID_HANDLE_VALUE), mapping(nullptr) {}
+#else
+    MappedFile() : data(nullptr), size(0), descriptor(-1) {}
+#endif
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        this->close();
+    }
+
+    bool open(const std::string& path) {
+        this->close();
+#ifdef _WIN32
+        this->file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (this->file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(this->file, &fileSize)) {
+            return false;
+        }
+        this->size = fileSize.QuadPart;
+        if (this->size == 0) { // an empty file cannot be mapped
+            return true;
+        }
+        this->mapping = CreateFileMappingA(this->file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!this->mapping) {
+            return false;
+        }
+        this->data = (const char*)MapViewOfFile(this->mapping, FILE_MAP_READ, 0, 0, 0);
+        return this->data != nullptr;
+#else
+        this->descriptor = ::open(path.c_str(), O_RDONLY);
+        if (this->descriptor < 0) {
+            return false;
+        }
+        struct stat info;
+        if (fstat(this->descriptor, &info) != 0) {
+            return false;
+        }
+        this->size = info.st_size;
+        if (this->size == 0) {
+            return true;
+        }
+        void* view = mmap(nullptr, (size_t)this->size, PROT_READ, MAP_PRIVATE, this->descriptor, 0);
+        if (view == MAP_FAILED) {
+            return false;
+        }
+        this->data = (const char*)view;
+        return true;
+#endif
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (this->data) {
+            UnmapViewOfFile(this->data);
+        }
+        if (this->mapping) {
+            CloseHandle(this->mapping);
+        }
+        if (this->file != INVALID_HANDLE_VALUE) {
+            CloseHandle(this->file);
+        }
+        this->mapping = nullptr;
+        this->file = INVALID_HANDLE_VALUE;
+#else
+        if (this->data) {
+            munmap((void*)this->data, (size_t)this->size);
+        }
+        if (this->descriptor >= 0) {
+            ::close(this->descriptor);
+        }
+        this->descriptor = -1;
+#endif
+        this->data = nullptr;
+        this->size = 0;
+    }
+
+    const char* getData() const {
+        return this->data;
+    }
+
+    long long getSize() const {
+        return this->size;
+    }
+};
+
+// binary roster snapshot, laid out so that it can be used straight from the mapped file:
+//   header | specialty names (offset + length) | one fixed-size record per doctor | intervals | string table
+// every name is stored once in the string table, and records point into it; numbers are in the machine's own byte order
+struct RosterString {
+    unsigned int offset; // into the string table
+    unsigned int length;
+};
+
+struct RosterHeader {
+    char magic[4]; // "HW8R"
+    unsigned int version;
+    unsigned int doctorCount;
+    unsigned int specialtyCount;
+    unsigned int intervalCount;
+    unsigned int stringBytes;
+    unsigned long long fileSize; // lets us notice a truncated file right away
+};
+
+struct RosterRecord {
+    unsigned long long specialtyMask; // in the file's own specialty ids (those of the registry that saved it)
+    RosterString name;
+    unsigned int firstInterval; // the doctor's extra shifts come first, then their time off
+    unsigned short shiftCount;
+    unsigned short timeOffCount;
+    unsigned char specialtyIds[Doctor::MAX_SPECIALTIES];
+    unsigned char specialtyCount;
+    unsigned char preferredWorkingDay;
+    unsigned char workingHoursStart;
+    unsigned char workingHoursEnd;
+    unsigned int reserved; // keeps records at 40 bytes, so the 64-bit masks of consecutive records stay aligned
+};
+
+static_assert(sizeof(RosterHeader) == 32, "the roster header must have the same layout everywhere");
+static_assert(sizeof(RosterRecord) == 40, "roster records must have the same layout everywhere");
+
+const unsigned int ROSTER_VERSION = 1;
+
+bool saveRoster(const std::string& path, const Doctor* doctors, int count) {
+    const SpecialtyRegistry& registry = SpecialtyRegistry::instance();
+    RosterHeader header;
+    memcpy(header.magic, "HW8R", 4);
+    header.version = ROSTER_VERSION;
+    header.doctorCount = count;
+    header.specialtyCount = registry.getCount();
+    header.intervalCount = 0;
+    unsigned long long stringBytes = 0;
+    for (int i = 0; i < registry.getCount(); i++) {
+        stringBytes += registry.getName(i).length();
+    }
+    for (int d = 0; d < count; d++) {
+        if (doctors[d].getExtraShifts().getCount() > 65535 || doctors[d].getTimeOff().getCount() > 65535) {
+            std::cout << "Too many intervals for doctor " << d + 1 << "!" << std::endl;
+            return false;
+        }
+        header.intervalCount += doctors[d].getExtraShifts().getCount() + doctors[d].getTimeOff().getCount();
+        stringBytes += doctors[d].getName().length();
+    }
+    if (stringBytes > 0xFFFFFFFFull) {
+        std::cout << "Names too long for a roster file!" << std::endl;
+        return false;
+    }
+    header.stringBytes = (unsigned int)stringBytes;
+    header.fileSize = sizeof(RosterHeader) + sizeof(RosterString) * header.specialtyCount + sizeof(RosterRecord) * (unsigned long long)count
+        + 8ull * header.intervalCount + stringBytes;
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cout << "Cannot open " << path << "!" << std::endl;
+        return false;
+    }
+    file.write((const char*)&header, sizeof(header));
+    unsigned int stringOffset = 0; // the string table holds the specialty names, then the doctor names, in this order
+    for (int i = 0; i < registry.getCount(); i++) {
+        RosterString name = { stringOffset, (unsigned int)registry.getName(i).length() };
+        file.write((const char*)&name, sizeof(name));
+        stringOffset += name.length;
+    }
+    unsigned int interval = 0;
+    for (int d = 0; d < count; d++) {
+        const Doctor& doctor = doctors[d];
+        RosterRecord record;
+        memset(&record, 0, sizeof(record)); // no uninitialized padding bytes in the file
+        record.specialtyMask = doctor.getSpecialtyMask();
+        record.name.offset = stringOffset;
+        record.name.length = (unsigned int)doctor.getName().length();
+        stringOffset += record.name.length;
+        record.firstInterval = interval;
+        record.shiftCount = (unsigned short)doctor.getExtraShifts().getCount();
+        record.timeOffCount = (unsigned short)doctor.getTimeOff().getCount();
+        interval += record.shiftCount + record.timeOffCount;
+        SpecialtySpan specialties = doctor.getSpecialties();
+        record.specialtyCount = (unsigned char)specialties.size();
+        for (int i = 0; i < specialties.size(); i++) {
+            record.specialtyIds[i] = (unsigned char)specialties[i];
+        }
+        record.preferredWorkingDay = (unsigned char)doctor.getPreferredWorkingDay();
+        record.workingHoursStart = (unsigned char)doctor.getWorkingHoursStart();
+        record.workingHoursEnd = (unsigned char)doctor.getWorkingHoursEnd();
+        file.write((const char*)&record, sizeof(record));
+    }
+    for (int d = 0; d < count; d++) {
+        const IntervalList* lists[2] = { &doctors[d].getExtraShifts(), &doctors[d].getTimeOff() };
+        for (int l = 0; l < 2; l++) {
+            for (int i = 0; i < lists[l]->getCount(); i++) {
+                int pair[2] = { lists[l]->getStart(i), lists[l]->getEnd(i) };
+                file.write((const char*)pair, sizeof(pair));
+            }
+        }
+    }
+    for (int i = 0; i < registry.getCount(); i++) {
+        file.write(registry.getName(i).data(), registry.getName(i).length());
+    }
+    for (int d = 0; d < count; d++) {
+        const std::string name = doctors[d].getName();
+        file.write(name.data(), name.length());
+    }
+    file.close();
+    if (!file) {
+        std::cout << "Failed writing " << path << "!" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+class RosterSnapshot { // a roster file mapped into memory; doctors are read from it only when asked for
+    // opening only checks the file and matches its specialties with the registry, so a 1M doctor roster opens in milliseconds;
+    // the small getters read single fields straight from the mapped records (enough for SchedulingIndex and ScheduleTree
+    // to be built from the snapshot directly), and getDoctor/loadInto build real Doctor objects
+    // beware: the pointers we return point into the mapping, so they are only valid while the snapshot is open
+private:
+    MappedFile file;
+    const RosterHeader* header;
+    const RosterRecord* records;
+    const int* intervals; // start, end pairs
+    const char* strings;
+    unsigned char registryIds[SpecialtyRegistry::MAX_SPECIALTIES]; // file specialty id -> our registry's id
+
+    static bool inside(const RosterString& text, unsigned int stringBytes) {
+        return (unsigned long long)text.offset + text.length <= stringBytes;
+    }
+
+    bool validate() { // makes sure nothing in the file points outside of it, so the getters don't need any checks
+        long long size = this->file.getSize();
+        if (size < (long long)sizeof(RosterHeader)) {
+            return false;
+        }
+        this->header = (const RosterHeader*)this->file.getData();
+        if (memcmp(this->header->magic, "HW8R", 4) != 0 || this->header->version != ROSTER_VERSION ||
+            this->header->fileSize != (unsigned long long)size || this->header->specialtyCount > (unsigned int)SpecialtyRegistry::MAX_SPECIALTIES) {
+            return false;
+        }
+        unsigned long long expected = sizeof(RosterHeader) + sizeof(RosterString) * this->header->specialtyCount
+            + sizeof(RosterRecord) * (unsigned long long)this->header->doctorCount + 8ull * this->header->intervalCount + this->header->stringBytes;
+        if (expected != (unsigned long long)size || this->header->doctorCount > 0x7FFFFFFFu) {
+            return false;
+        }
+        const RosterString* specialties = (const RosterString*)(this->file.getData() + sizeof(RosterHeader));
+        this->records = (const RosterRecord*)(specialties + this->header->specialtyCount);
+        this->intervals = (const int*)(this->records + this->header->doctorCount);
+        this->strings = (const char*)(this->intervals + 2ull * this->header->intervalCount);
+
+        for (unsigned int i = 0; i < this->header->specialtyCount; i++) {
+            if (!inside(specialties[i], this->header->stringBytes)) {
+                return false;
+            }
+        }
+        for (unsigned int d = 0; d < this->header->doctorCount; d++) {
+            const RosterRecord& record = this->records[d];
+            if (!inside(record.name, this->header->stringBytes) || record.specialtyCount > Doctor::MAX_SPECIALTIES ||
+                record.preferredWorkingDay < 1 || record.preferredWorkingDay > 7 || record.workingHoursStart >= record.workingHoursEnd ||
+                record.workingHoursEnd > 23 ||
+                (unsigned long long)record.firstInterval + record.shiftCount + record.timeOffCount > this->header->intervalCount) {
+                return false;
+            }
+            for (int i = 0; i < record.specialtyCount; i++) {
+                if (record.specialtyIds[i] >= this->header->specialtyCount) {
+                    return false;
+                }
+            }
+        }
+        for (unsigned int i = 0; i < this->header->intervalCount; i++) {
+            if (this->intervals[2 * i] < 0 || this->intervals[2 * i] >= this->intervals[2 * i + 1] || this->intervals[2 * i + 1] > MINUTES_PER_WEEK) {
+                return false;
+            }
+        }
+
+        // the file's ids might not be ours, so we map them; first make sure all the names the registry doesn't know yet fit in it,
+        // so that a file we reject doesn't leave some of its names registered
+        SpecialtyRegistry& registry = SpecialtyRegistry::instance();
+        int newNames = 0;
+        for (unsigned int i = 0; i < this->header->specialtyCount; i++) {
+            std::string name(this->strings + specialties[i].offset, specialties[i].length);
+            bool seen = registry.find(name) != -1;
+            for (unsigned int j = 0; j < i && !seen; j++) { // the same new name twice in the file only takes one id
+                seen = name == std::string(this->strings + specialties[j].offset, specialties[j].length);
+            }
+            newNames += seen ? 0 : 1;
+        }
+        if (registry.getCount() + newNames > SpecialtyRegistry::MAX_SPECIALTIES) {
+            std::cout << "Cannot have more than " << SpecialtyRegistry::MAX_SPECIALTIES << " different specialties!" << std::endl;
+            return false;
+        }
+        for (unsigned int i = 0; i < this->header->specialtyCount; i++) { // everything checked, now nothing can fail
+            this->registryIds[i] = (unsigned char)registry.add(std::string(this->strings + specialties[i].offset, specialties[i].length));
+        }
+        return true;
+    }
+
+public:
+    RosterSnapshot() : header(nullptr), records(nullptr), intervals(nullptr), strings(nullptr) {}
+
+    RosterSnapshot(const RosterSnapshot&) = delete;
+    RosterSnapshot& operator=(const RosterSnapshot&) = delete;
+
+    bool open(const std::string& path) { // false if the file is missing or not a valid roster
+        this->header = nullptr;
+        if (!this->file.open(path)) {
+            return false;
+        }
+        if (!this->validate()) {
+            std::cout << path << " is not a valid roster file!" << std::endl;
+            this->file.close();
+            this->header = nullptr;
+            return false;
+        }
+        return true;
+    }
+
+    int getDoctorCount() const {
+        return this->header ? (int)this->header->doctorCount : 0;
+    }
+
+    const char* getName(int d, int& length) const { // not null-terminated, hence the length
+        length = (int)this->records[d].name.length;
+        return this->strings + this->records[d].name.offset;
+    }
+
+    bool hasSpecialty(int d, int registryId) const {
+        const RosterRecord& record = this->records[d];
+        for (int i = 0; i < record.specialtyCount; i++) {
+            if (this->registryIds[record.specialtyIds[i]] == registryId) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    unsigned long long getSpecialtyMask(int d) const { // in our registry's ids
+        unsigned long long mask = 0;
+        const RosterRecord& record = this->records[d];
+        for (int i = 0; i < record.specialtyCount; i++) {
+            mask |= 1ull << this->registryIds[record.specialtyIds[i]];
+        }
+        return mask;
+    }
+
+    int getSpecialtyIds(int d, unsigned char* ids) const { // same as DoctorArray::getSpecialtyIds
+        const RosterRecord& record = this->records[d];
+        for (int i = 0; i < record.specialtyCount; i++) {
+            ids[i] = this->registryIds[record.specialtyIds[i]];
+        }
+        return record.specialtyCount;
+    }
+
+    const IntervalList& getAvailability(int d, IntervalList& scratch) const {
+        // the minutes the doctor works, computed into "scratch" the same way Doctor::updateAvailability does, without building the doctor
+        // (the intervals of one record were saved sorted and merged, so adding them back in order never moves anything)
+        const RosterRecord& record = this->records[d];
+        const int* interval = this->intervals + 2ull * record.firstInterval;
+        scratch.clear();
+        for (int i = 0; i < record.shiftCount; i++, interval += 2) {
+            scratch.add(interval[0], interval[1]);
+        }
+        scratch.add(minuteOfWeek(record.preferredWorkingDay, record.workingHoursStart, 0),
+            minuteOfWeek(record.preferredWorkingDay, record.workingHoursEnd, 0) + 60);
+        if (record.timeOffCount) {
+            IntervalList timeOff;
+            for (int i = 0; i < record.timeOffCount; i++, interval += 2) {
+                timeOff.add(interval[0], interval[1]);
+            }
+            scratch.subtract(timeOff);
+        }
+        return scratch;
+    }
+
+    Doctor getDoctor(int d) const { // builds the whole doctor (returned by value, which moves it out)
+        const RosterRecord& record = this->records[d];
+        unsigned char ids[Doctor::MAX_SPECIALTIES];
+        for (int i = 0; i < record.specialtyCount; i++) {
+            ids[i] = this->registryIds[record.specialtyIds[i]];
+        }
+        Doctor doctor(std::string(this->strings + record.name.offset, record.name.length), ids, record.specialtyCount,
+            record.preferredWorkingDay, record.workingHoursStart, record.workingHoursEnd);
+        const int* interval = this->intervals + 2ull * record.firstInterval;
+        for (int i = 0; i < record.shiftCount; i++, interval += 2) {
+            doctor.addShift(interval[0], interval[1]);
+        }
+        for (int i = 0; i < record.timeOffCount; i++, interval += 2) {
+            doctor.addTimeOff(interval[0], interval[1]);
+        }
+        return doctor;
+    }
+
+    void loadInto(DoctorRoster& roster) const { // replaces the roster's doctors with ours
+        roster.clear();
+        roster.reserve(this->getDoctorCount());
+        for (int d = 0; d < this->getDoctorCount(); d++) {
+            roster.emplace(this->getDoctor(d));
+        }
+    }
+};
+
+class LazyRoster { // the program's doctors: read straight from a roster snapshot, and only built as Doctor objects when needed
+    // after opening a snapshot, scheduling (the indexes are built from the mapped records) and looking up names need no Doctor at all;
+    // printing a doctor builds a temporary one, and editing one builds just that doctor, which then replaces its record;
+    // getRoster() builds them all (and closes the snapshot), for the rare things that need every Doctor, like saving
+    // without a snapshot, this is just a DoctorRoster
+private:
+    DoctorRoster doctors; // every doctor, when there's no snapshot
+    RosterSnapshot* snapshot;
+    Doctor** edited; // with a snapshot: edited[d] is the doctor built for an edit, or nullptr while it's only in the file
+
+    void closeSnapshot() {
+        if (this->snapshot) {
+            for (int d = 0; d < this->snapshot->getDoctorCount(); d++) {
+                delete this->edited[d];
+            }
+            delete[] this->edited;
+            delete this->snapshot;
+        }
+        this->edited = nullptr;
+        this->snapshot = nullptr;
+    }
+
+public:
+    LazyRoster() : snapshot(nullptr), edited(nullptr) {}
+
+    LazyRoster(const LazyRoster&) = delete;
+    LazyRoster& operator=(const LazyRoster&) = delete;
+
+    ~LazyRoster() {
+        this->closeSnapshot();
+    }
+
+    bool open(const std::string& path) { // switches to the doctors of a roster file; on failure, the current doctors are kept
+        RosterSnapshot* opened = new RosterSnapshot();
+        if (!opened->open(path)) {
+            delete opened;
+            return false;
+        }
+        this->closeSnapshot();
+        this->doctors.clear();
+        this->snapshot = opened;
+        this->edited = new Doctor*[opened->getDoctorCount() > 0 ? opened->getDoctorCount() : 1]();  // "()" fills it with nullptr
+        return true;
+    }
+
+    DoctorRoster& getRoster() { // all the doctors as real objects (builds the ones still in the snapshot, then closes it)
+        if (this->snapshot) {
+            int count = this->snapshot->getDoctorCount();
+            this->doctors.clear();
+            this->doctors.reserve(count);
+            for (int d = 0; d < count; d++) {
+                if (this->edited[d]) {
+                    this->doctors.emplace(std::move(*this->edited[d]));
+                }
+                else {
+                    this->doctors.emplace(this->snapshot->getDoctor(d));
+                }
+            }
+            this->closeSnapshot();
+        }
+        return this->doctors;
+    }
+
+    int getSize() const {
+        return this->snapshot ? this->snapshot->getDoctorCount() : this->doctors.getSize();
+    }
+
+    std::string getName(int d) const {
+        if (this->snapshot && !this->edited[d]) {
+            int length;
+            const char* name = this->snapshot->getName(d, length);
+            return std::string(name, length);
+        }
+        return this->snapshot ? this->edited[d]->getName() : this->doctors[d].getName();
+    }
+
+    void print(int d) const {
+        if (this->snapshot && !this->edited[d]) {
+            this->snapshot->getDoctor(d).print(); // a temporary doctor, just for printing
+        }
+        else {
+            (this->snapshot ? *this->edited[d] : this->doctors[d]).print();
+        }
+    }
+
+    Doctor& edit(int d) { // the doctor, to be changed (the indexes have to be rebuilt afterwards)
+        if (!this->snapshot) {
+            return this->doctors[d];
+        }
+        if (!this->edited[d]) {
+            this->edited[d] = new Doctor(this->snapshot->getDoctor(d));
+        }
+        return *this->edited[d];
+    }
+
+    // what SchedulingIndex::buildFrom and ScheduleTree::buildFrom need, from wherever the doctor currently is
+    unsigned long long getSpecialtyMask(int d) const {
+        if (this->snapshot && !this->edited[d]) {
+            return this->snapshot->getSpecialtyMask(d);
+        }
+        return (this->snapshot ? *this->edited[d] : this->doctors[d]).getSpecialtyMask();
+    }
+
+    int getSpecialtyIds(int d, unsigned char* ids) const {
+        if (this->snapshot && !this->edited[d]) {
+            return this->snapshot->getSpecialtyIds(d, ids);
+        }
+        return DoctorArray(this->snapshot ? this->edited[d] : &this->doctors[d]).getSpecialtyIds(0, ids);
+    }
+
+    const IntervalList& getAvailability(int d, IntervalList& scratch) const {
+        if (this->snapshot && !this->edited[d]) {
+            return this->snapshot->getAvailability(d, scratch);
+        }
+        return (this->snapshot ? *this->edited[d] : this->doctors[d]).getAvailability();
+    }
+};
+
+static int lowestSetBit(unsigned int bits) { // index of the lowest 1 bit (bits must not be 0)
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, bits);
+    return (int)index;
+#elif defined(__GNUC__)
+    return __builtin_ctz(bits); // a single instruction on x86/ARM
+#else
+    int index = 0;
+    while (!(bits & 1u)) {
+        bits >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+class SchedulingIndex { // answers "which doctors have specialty X and work on day D at hour H" without scanning all the doctors
+    // built once from the doctors array (and rebuilt if the doctors change), it holds:
+    // - an inverted index: specialty -> ids (positions in the doctors array) of the doctors having it
+    // - a 7x24 availability bitmap per doctor: bit H of availability[doctor * 7 + D - 1] is set if the doctor works at that hour
+    // - for every (specialty, day, hour), the doctors matching both; this is the AND of the specialty's doctors and the
+    //   availability bitmaps, done once at build time, so a query is just a lookup
+    // the lists are stored back to back in one array ("offsets" says where each list starts), rather than one array per list,
+    // which for 100k doctors saves thousands of small allocations and keeps each list contiguous in memory
+private:
+    static const int DAYS = 7;
+    static const int HOURS = 24;
+    static const int SLOTS = DAYS * HOURS;
+
+    int specialtyCount; // how many registry ids existed at build time
+    int doctorCount;
+    unsigned int* availability; // doctorCount * 7 bitmaps of 24 bits
+    int* specialtyOffsets; // the doctors of specialty S are specialtyDoctors[specialtyOffsets[S] .. specialtyOffsets[S + 1])
+    int* specialtyDoctors;
+    int* matchOffsets; // same, for the list of (specialty, slot) S * SLOTS + (D - 1) * 24 + H
+    int* matches;
+
+    void release() {
+        delete[] this->availability;
+        delete[] this->specialtyOffsets;
+        delete[] this->specialtyDoctors;
+        delete[] this->matchOffsets;
+        delete[] this->matches;
+        this->availability = nullptr;
+        this->specialtyOffsets = this->specialtyDoctors = this->matchOffsets = this->matches = nullptr;
+        this->doctorCount = 0;
+        this->specialtyCount = 0;
+    }
+
+    static bool validSlot(int day, int hour) {
+        return day >= 1 && day <= DAYS && hour >= 0 && hour < HOURS;
+    }
+
+public:
+    SchedulingIndex() : specialtyCount(0), doctorCount(0), availability(nullptr), specialtyOffsets(nullptr), specialtyDoctors(nullptr),
+        matchOffsets(nullptr), matches(nullptr) {}
+
+    SchedulingIndex(const SchedulingIndex&) = delete;
+    SchedulingIndex& operator=(const SchedulingIndex&) = delete;
+
+    ~SchedulingIndex() {
+        this->release();
+    }
+
+    void build(const Doctor* doctors, int count) {
+        this->buildFrom(DoctorArray(doctors), count);
+    }
+
+    // "doctors" can be anything with getSpecialtyIds(d, ids) and getAvailability(d, scratch), like DoctorArray, RosterSnapshot
+    // or LazyRoster, so the index can also be built from a mapped roster without creating any Doctor
+    template <typename Doctors>
+    void buildFrom(const Doctors& doctors, int count) {
+        this->release();
+        this->doctorCount = count;
+        this->availability = new unsigned int[count * DAYS];
+        IntervalList scratch;
+        unsigned char ids[Doctor::MAX_SPECIALTIES];
+
+        // first pass: the availability bitmaps (the specialties already come as registry ids, so there is nothing to look up)
+        for (int d = 0; d < count; d++) {
+            for (int day = 0; day < DAYS; day++) {
+                this->availability[d * DAYS + day] = 0;
+            }
+            const IntervalList& available = doctors.getAvailability(d, scratch);
+            for (int i = 0; i < available.getCount(); i++) {
+                // only the hours the doctor works completely (same as worksAt)
+                int firstHour = (available.getStart(i) + 59) / 60;
+                int endHour = available.getEnd(i) / 60;
+                for (int hour = firstHour; hour < endHour; hour++) { // hours of the week, 0..167
+                    this->availability[d * DAYS + hour / HOURS] |= 1u << (hour % HOURS);
+                }
+            }
+        }
+
+        // second pass: count the size of every list, so that we can lay them out back to back
+        int specialtyCount = SpecialtyRegistry::instance().getCount();
+        this->specialtyCount = specialtyCount;
+        this->specialtyOffsets = new int[specialtyCount + 1];
+        this->matchOffsets = new int[specialtyCount * SLOTS + 1];
+        for (int i = 0; i <= specialtyCount; i++) {
+            this->specialtyOffsets[i] = 0;
+        }
+        for (int i = 0; i <= specialtyCount * SLOTS; i++) {
+            this->matchOffsets[i] = 0;
+        }
+        for (int d = 0; d < count; d++) {
+            int idCount = doctors.getSpecialtyIds(d, ids);
+            for (int i = 0; i < idCount; i++) {
+                int s = ids[i];
+                this->specialtyOffsets[s + 1]++;
+                for (int day = 0; day < DAYS; day++) {
+                    unsigned int bits = this->availability[d * DAYS + day];
+                    while (bits) {
+                        this->matchOffsets[s * SLOTS + day * HOURS + lowestSetBit(bits) + 1]++;
+                        bits &= bits - 1; // clears the lowest set bit
+                    }
+                }
+            }
+        }
+        for (int i = 0; i < specialtyCount; i++) { // turn the counts into starting positions
+            this->specialtyOffsets[i + 1] += this->specialtyOffsets[i];
+        }
+        for (int i = 0; i < specialtyCount * SLOTS; i++) {
+            this->matchOffsets[i + 1] += this->matchOffsets[i];
+        }
+
+        // third pass: fill the lists; doctors are visited in order, so every list ends up sorted by doctor id
+        this->specialtyDoctors = new int[this->specialtyOffsets[specialtyCount] > 0 ? this->specialtyOffsets[specialtyCount] : 1];
+        this->matches = new int[this->matchOffsets[specialtyCount * SLOTS] > 0 ? this->matchOffsets[specialtyCount * SLOTS] : 1];
+        int* specialtyFill = new int[specialtyCount > 0 ? specialtyCount : 1];
+        int* matchFill = new int[specialtyCount > 0 ? specialtyCount * SLOTS : 1];
+        for (int i = 0; i < specialtyCount; i++) {
+            specialtyFill[i] = this->specialtyOffsets[i];
+        }
+        for (int i = 0; i < specialtyCount * SLOTS; i++) {
+            matchFill[i] = this->matchOffsets[i];
+        }
+        for (int d = 0; d < count; d++) {
+            int idCount = doctors.getSpecialtyIds(d, ids);
+            for (int i = 0; i < idCount; i++) {
+                int s = ids[i];
+                this->specialtyDoctors[specialtyFill[s]++] = d;
+                for (int day = 0; day < DAYS; day++) {
+                    unsigned int bits = this->availability[d * DAYS + day];
+                    while (bits) {
+                        this->matches[matchFill[s * SLOTS + day * HOURS + lowestSetBit(bits)]++] = d;
+                        bits &= bits - 1;
+                    }
+                }
+            }
+        }
+
+        delete[] specialtyFill;
+        delete[] matchFill;
+    }
+
+    int getSpecialtyId(const std::string& specialty) const { // -1 if no doctor has it
+        return SpecialtyRegistry::instance().find(specialty);
+    }
+
+    bool isAvailable(int doctor, int day, int hour) const {
+        if (doctor < 0 || doctor >= this->doctorCount || !validSlot(day, hour)) {
+            return false;
+        }
+        return (this->availability[doctor * DAYS + day - 1] >> hour) & 1u;
+    }
+
+    const int* getDoctorsWith(int specialtyId, int& count) const { // ids of the doctors having the specialty
+        // beware: the array belongs to the index (don't delete it), and is only valid until the next build
+        if (specialtyId < 0 || specialtyId >= this->specialtyCount) {
+            count = 0;
+            return nullptr;
+        }
+        count = this->specialtyOffsets[specialtyId + 1] - this->specialtyOffsets[specialtyId];
+        return this->specialtyDoctors + this->specialtyOffsets[specialtyId];
+    }
+
+    const int* findAll(int specialtyId, int day, int hour, int& count) const { // ids of all the matching doctors (same rules as above)
+        std::chrono::steady_clock::time_point start = SchedulingStats::start();
+        if (specialtyId < 0 || specialtyId >= this->specialtyCount || !validSlot(day, hour)) {
+            count = 0;
+            SchedulingStats::instance().lookups.record(start, false, 0);
+            return nullptr;
+        }
+        int list = specialtyId * SLOTS + (day - 1) * HOURS + hour;
+        count = this->matchOffsets[list + 1] - this->matchOffsets[list];
+        SchedulingStats::instance().lookups.record(start, count > 0, count); // the answer is precomputed, so the candidates are just the ones returned
+        return this->matches + this->matchOffsets[list];
+    }
+
+    const int* findAll(const std::string& specialty, int day, int hour, int& count) const {
+        return this->findAll(this->getSpecialtyId(specialty), day, hour, count);
+    }
+
+    int findFirst(int specialtyId, int day, int hour) const { // id of the first matching doctor, or -1
+        int count;
+        const int* found = this->findAll(specialtyId, day, hour, count);
+        return count > 0 ? found[0] : -1;
+    }
+
+    int findFirst(const std::string& specialty, int day, int hour) const {
+        return this->findFirst(this->getSpecialtyId(specialty), day, hour);
+    }
+};
+
+class ScheduleTree { // "which doctors are free the whole time from minute A to minute B", in logarithmic time over all doctors
+    // every free interval of every doctor goes into one array sorted by start, which we treat as a balanced binary tree:
+    // the middle element is the root, the middle of the left half its left child, and so on (so the tree needs no pointers)
+    // every node also remembers the latest end in its subtree; a doctor is free during [A, B) if one of their intervals
+    // starts at or before A and ends at or after B, so we can skip any subtree whose latest end is before B,
+    // and any right subtree once the starts pass A: a query costs O(log n) plus a bit for every doctor found
+private:
+    struct Entry {
+        int start;
+        int end;
+        int doctor;
+        unsigned long long specialties; // copied here so that filtering by specialty doesn't have to look at the doctor
+    };
+
+    Entry* entries;
+    int* maxEnd; // maxEnd[i] = latest end in the subtree whose root is entries[i]
+    int count;
+
+    int buildMaxEnd(int low, int high) { // subtree over entries[low, high), returns its latest end
+        if (low >= high) {
+            return -1;
+        }
+        int middle = (low + high) / 2;
+        int latest = std::max(this->entries[middle].end, std::max(this->buildMaxEnd(low, middle), this->buildMaxEnd(middle + 1, high)));
+        this->maxEnd[middle] = latest;
+        return latest;
+    }
+
+    void search(int low, int high, int start, int end, unsigned long long mask, int* result, int maxResults, int& found, int& visited) const {
+        if (low >= high || found == maxResults) {
+            return;
+        }
+        int middle = (low + high) / 2;
+        visited++;
+        if (this->maxEnd[middle] < end) {
+            return; // nothing in here lasts long enough
+        }
+        this->search(low, middle, start, end, mask, result, maxResults, found, visited);
+        const Entry& entry = this->entries[middle];
+        if (entry.start > start) {
+            return; // this one and the whole right subtree start too late
+        }
+        if (entry.end >= end && (entry.specialties & mask) && found < maxResults) {
+            result[found++] = entry.doctor;
+        }
+        this->search(middle + 1, high, start, end, mask, result, maxResults, found, visited);
+    }
+
+public:
+    ScheduleTree() : entries(nullptr), maxEnd(nullptr), count(0) {}
+
+    ScheduleTree(const ScheduleTree&) = delete;
+    ScheduleTree& operator=(const ScheduleTree&) = delete;
+
+    ~ScheduleTree() {
+        delete[] this->entries;
+        delete[] this->maxEnd;
+    }
+
+    void build(const Doctor* doctors, int doctorCount) {
+        this->buildFrom(DoctorArray(doctors), doctorCount);
+    }
+
+    template <typename Doctors>
+    void buildFrom(const Doctors& doctors, int doctorCount) { // same sources as SchedulingIndex::buildFrom
+        delete[] this->entries;
+        delete[] this->maxEnd;
+        IntervalList scratch;
+        this->count = 0;
+        for (int d = 0; d < doctorCount; d++) {
+            this->count += doctors.getAvailability(d, scratch).getCount();
+        }
+        this->entries = new Entry[this->count > 0 ? this->count : 1];
+        this->maxEnd = new int[this->count > 0 ? this->count : 1];
+        int filled = 0;
+        for (int d = 0; d < doctorCount; d++) {
+            const IntervalList& available = doctors.getAvailability(d, scratch);
+            unsigned long long mask = doctors.getSpecialtyMask(d);
+            for (int i = 0; i < available.getCount(); i++) {
+                this->entries[filled++] = Entry{ available.getStart(i), available.getEnd(i), d, mask };
+            }
+        }
+        // a lambda telling std::sort how to order two entries
+        std::sort(this->entries, this->entries + this->count, [](const Entry& a, const Entry& b) { return a.start < b.start; });
+        this->buildMaxEnd(0, this->count);
+    }
+
+    // ids of the doctors free the whole time from startMinute to endMinute (with the specialty, unless it is -1)
+    // the search stops after maxResults doctors (returns how many it wrote into "result"), so asking for a few is logarithmic,
+    // while asking for all of them costs a bit more for every doctor found
+    // a doctor's free intervals never overlap, so nobody is reported twice
+    int findFree(int startMinute, int endMinute, int specialtyId, int* result, int maxResults) const {
+        unsigned long long mask = ~0ull;
+        if (specialtyId != -1) {
+            if (specialtyId < 0 || specialtyId >= SpecialtyRegistry::MAX_SPECIALTIES) {
+                return 0;
+            }
+            mask = 1ull << specialtyId;
+        }
+        std::chrono::steady_clock::time_point start = SchedulingStats::start();
+        int found = 0;
+        int visited = 0;
+        this->search(0, this->count, startMinute, endMinute, mask, result, maxResults, found, visited);
+        SchedulingStats::instance().freeSearches.record(start, found > 0, visited);
+        return found;
+    }
+};
+
+const int benchmarkSpecialtyCount = 16;
+const std::string benchmarkSpecialties[benchmarkSpecialtyCount] = { "Cardiology", "Intensivist", "Dermatology", "Neurology", "Psychiatry",
+    "Neurosurgery", "Pediatrics", "Oncology", "Radiology", "Urology", "Orthopedics", "Ophthalmology", "Gastroenterology", "Endocrinology",
+    "Nephrology", "Rheumatology" };
+
+static unsigned int nextRandom(unsigned int& state) { // xorshift, a tiny and fast random generator (unlike rand(), each thread can have its own)
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+Doctor* generateDoctors(int doctorCount) { // a big random roster for the benchmarks (the caller must delete[] it)
+    unsigned int state = 2463534242u;
+    Doctor* doctors = new Doctor[doctorCount];
+    std::string specs[3];
+    for (int i = 0; i < doctorCount; i++) {
+        int count = 1 + (int)(nextRandom(state) % 3);
+        for (int j = 0; j < count; j++) {
+            specs[j] = benchmarkSpecialties[nextRandom(state) % benchmarkSpecialtyCount];
+        }
+        int start = (int)(nextRandom(state) % 16);
+        doctors[i].setName("Doctor #" + std::to_string(i));
+        doctors[i].setSpecialties(specs, count);
+        doctors[i].setPreferredWorkingDay(1 + (int)(nextRandom(state) % 7));
+        doctors[i].setWorkingHoursEnd(23); // widen the default 8-16 first, so the start can be set to any hour
+        doctors[i].setWorkingHoursStart(start);
+        doctors[i].setWorkingHoursEnd(start + 1 + (int)(nextRandom(state) % 8));
+        unsigned int extra = nextRandom(state);
+        if (extra % 4 == 0) { // every 4th doctor also has a shift on another day, at minute precision
+            int shiftStart = minuteOfWeek(1 + (int)(extra >> 4) % 7, 6 + (int)(extra >> 8) % 10, (int)(extra >> 12) % 4 * 15);
+            doctors[i].addShift(shiftStart, shiftStart + 60 + (int)(extra >> 16) % 6 * 30);
+        }
+        if (extra % 8 == 1) { // and every 8th one takes some time off
+            int offStart = minuteOfWeek(doctors[i].getPreferredWorkingDay(), start, (int)(extra >> 8) % 60);
+            doctors[i].addTimeOff(offStart, offStart + 30 + (int)(extra >> 16) % 90);
+        }
+    }
+    return doctors;
+}
+
+void runSchedulingBenchmark() { // compares the index against the plain scan over the doctors, on a big generated roster
+    const int doctorCount = 100000;
+    const std::string* names = benchmarkSpecialties;
+    const int specialtyNames = benchmarkSpecialtyCount;
+    unsigned int state = 88172645u;
+    auto next = [&state]() { // a lambda is an unnamed function written in place; [&state] lets it change our local "state"
+        return nextRandom(state);
+    };
+
+    Doctor* doctors = generateDoctors(doctorCount);
+    SchedulingIndex index;
+    auto begin = std::chrono::steady_clock::now();
+    index.build(doctors, doctorCount);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << "Indexed " << doctorCount << " doctors in " << seconds * 1000 << " ms" << std::endl;
+
+    // the scan is far too slow to run millions of times, so it only gets a small sample (which also checks both agree)
+    const int scanQueries = 2000;
+    int mismatches = 0;
+    begin = std::chrono::steady_clock::now();
+    for (int q = 0; q < scanQueries; q++) {
+        const std::string& spec = names[next() % specialtyNames];
+        int day = 1 + (int)(next() % 7);
+        int hour = (int)(next() % 24);
+        int found = -1;
+        for (int i = 0; i < doctorCount; i++) {
+            if (doctors[i].hasSpecialty(spec) && doctors[i].worksAt(day, hour)) {
+                found = i;
+                break;
+            }
+        }
+        if (found != index.findFirst(spec, day, hour)) {
+            mismatches++;
+        }
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << "Scan: " << (long long)(scanQueries / seconds) << " queries/s (" << mismatches << " mismatches with the index)" << std::endl;
+
+    const int indexQueries = 10000000;
+    long long checksum = 0; // use the results, so the compiler can't throw the queries away
+    begin = std::chrono::steady_clock::now();
+    for (int q = 0; q < indexQueries; q++) {
+        unsigned int r = next();
+        int count;
+        index.findAll(names[r % specialtyNames], 1 + (int)((r >> 8) % 7), (int)((r >> 16) % 24), count);
+        checksum += count;
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << "Index: " << (long long)(indexQueries / seconds) << " queries/s (checksum " << checksum << ")" << std::endl;
+
+    // minute precision: "who is free from A to B", through the interval tree and through the scan
+    ScheduleTree tree;
+    begin = std::chrono::steady_clock::now();
+    tree.build(doctors, doctorCount);
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << "Interval tree built in " << seconds * 1000 << " ms" << std::endl;
+    const int freeQueries = 200000;
+    int* found = new int[doctorCount];
+    int* queryStart = new int[freeQueries];
+    int* queryEnd = new int[freeQueries];
+    for (int q = 0; q < freeQueries; q++) {
+        unsigned int r = next();
+        queryStart[q] = minuteOfWeek(1 + (int)(r % 7), 6 + (int)((r >> 4) % 14), (int)((r >> 9) % 60));
+        queryEnd[q] = queryStart[q] + 15 + (int)((r >> 16) % 60);
+    }
+    mismatches = 0;
+    begin = std::chrono::steady_clock::now();
+    for (int q = 0; q < scanQueries / 10; q++) {
+        int count = 0;
+        for (int i = 0; i < doctorCount; i++) {
+            if (doctors[i].isFreeDuring(queryStart[q], queryEnd[q])) {
+                count++;
+            }
+        }
+        if (count != tree.findFree(queryStart[q], queryEnd[q], -1, found, doctorCount)) {
+            mismatches++;
+        }
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << "Free-doctor scan: " << (long long)(scanQueries / 10 / seconds) << " queries/s (" << mismatches << " mismatches with the tree)" << std::endl;
+    checksum = 0;
+    begin = std::chrono::steady_clock::now();
+    for (int q = 0; q < freeQueries; q++) {
+        checksum += tree.findFree(queryStart[q], queryEnd[q], -1, found, 16); // the first 16 doctors are enough to pick from
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << "Free-doctor tree (first 16): " << (long long)(freeQueries / seconds) << " queries/s (checksum " << checksum << ")" << std::endl;
+    delete[] found;
+    delete[] queryStart;
+    delete[] queryEnd;
+
+    delete[] doctors;
+}
+
+class BookingStore { // remembers the appointments made, so a slot can't be handed out more times than the doctor can take
+    // every doctor can see "capacity" patients in each hour they work; we keep one counter per (doctor, day, hour)
+    // plus one counter per doctor with all their bookings (their load), used to spread patients evenly
+    // the counters are atomics changed with compare-and-swap, so any number of threads can book at the same time
+    // without a lock: a thread reads the counter, and only writes the new value if nobody changed it in the meantime (else it retries)
+private:
+    static const int SLOTS = 7 * 24;
+
+    const SchedulingIndex& index; // tells us who works when (must outlive the store)
+    int doctorCount;
+    int capacity;
+    std::atomic<int>* booked; // booked[doctor * SLOTS + (day - 1) * 24 + hour]
+    std::atomic<int>* load; // load[doctor]
+
+    static bool validSlot(int day, int hour) {
+        return day >= 1 && day <= 7 && hour >= 0 && hour < 24;
+    }
+
+public:
+    BookingStore(const SchedulingIndex& index, int doctorCount, int capacity) : index(index), doctorCount(doctorCount), capacity(capacity) {
+        if (this->capacity < 1) {
+            std::cout << "Capacity cannot be less than 1!" << std::endl;
+            this->capacity = 1;
+        }
+        this->booked = new std::atomic<int>[doctorCount * SLOTS];
+        this->load = new std::atomic<int>[doctorCount];
+        for (int i = 0; i < doctorCount * SLOTS; i++) {
+            this->booked[i].store(0, std::memory_order_relaxed);
+        }
+        for (int i = 0; i < doctorCount; i++) {
+            this->load[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    BookingStore(const BookingStore&) = delete;
+    BookingStore& operator=(const BookingStore&) = delete;
+
+    ~BookingStore() {
+        delete[] this->booked;
+        this->booked = nullptr;
+        delete[] this->load;
+        this->load = nullptr;
+    }
+
+    bool reserve(int doctor, int day, int hour) { // false if the doctor doesn't work then, or is fully booked
+        if (!this->index.isAvailable(doctor, day, hour)) {
+            return false;
+        }
+        std::atomic<int>& slot = this->booked[doctor * SLOTS + (day - 1) * 24 + hour];
+        int current = slot.load(std::memory_order_relaxed);
+        do {
+            if (current >= this->capacity) {
+                return false;
+            }
+            // compare_exchange_weak writes current + 1 only if the slot still holds "current"; if not, it loads the new value into "current"
+        } while (!slot.compare_exchange_weak(current, current + 1, std::memory_order_acq_rel, std::memory_order_relaxed));
+        this->load[doctor].fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool cancel(int doctor, int day, int hour) { // false if there was nothing to cancel
+        if (doctor < 0 || doctor >= this->doctorCount || !validSlot(day, hour)) {
+            return false;
+        }
+        std::atomic<int>& slot = this->booked[doctor * SLOTS + (day - 1) * 24 + hour];
+        int current = slot.load(std::memory_order_relaxed);
+        do {
+            if (current <= 0) {
+                return false;
+            }
+        } while (!slot.compare_exchange_weak(current, current - 1, std::memory_order_acq_rel, std::memory_order_relaxed));
+        this->load[doctor].fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    int book(const std::string& specialty, int day, int hour) { // books the least-loaded matching doctor with room left; returns their id or -1
+        std::chrono::steady_clock::time_point start = SchedulingStats::start();
+        long long examined = 0;
+        int count;
+        const int* candidates = this->index.findAll(specialty, day, hour, count);
+        while (true) {
+            int best = -1;
+            int bestLoad = 0;
+            examined += count;
+            for (int i = 0; i < count; i++) {
+                int doctor = candidates[i];
+                if (this->booked[doctor * SLOTS + (day - 1) * 24 + hour].load(std::memory_order_relaxed) >= this->capacity) {
+                    continue;
+                }
+                int doctorLoad = this->load[doctor].load(std::memory_order_relaxed);
+                if (best == -1 || doctorLoad < bestLoad) {
+                    best = doctor;
+                    bestLoad = doctorLoad;
+                }
+            }
+            if (best == -1) {
+                SchedulingStats::instance().bookings.record(start, false, examined);
+                return -1;
+            }
+            if (this->reserve(best, day, hour)) {
+                SchedulingStats::instance().bookings.record(start, true, examined);
+                return best;
+            }
+            // another thread took the last place in between, so we look again (each retry means one more slot got full, so this ends)
+        }
+    }
+
+    int getBooked(int doctor, int day, int hour) const {
+        if (doctor < 0 || doctor >= this->doctorCount || !validSlot(day, hour)) {
+            return 0;
+        }
+        return this->booked[doctor * SLOTS + (day - 1) * 24 + hour].load(std::memory_order_relaxed);
+    }
+
+    int getLoad(int doctor) const {
+        if (doctor < 0 || doctor >= this->doctorCount) {
+            return 0;
+        }
+        return this->load[doctor].load(std::memory_order_relaxed);
+    }
+
+    int getCapacity() const {
+        return this->capacity;
+    }
+};
+
+void runBookingBenchmark() { // many threads booking at once; afterwards we check that no slot was overbooked
+    const int doctorCount = 100000;
+    const int requestsPerThread = 200000;
+    Doctor* doctors = generateDoctors(doctorCount);
+    SchedulingIndex index;
+    index.build(doctors, doctorCount);
+
+    int maxThreads = (int)std::thread::hardware_concurrency();
+    if (maxThreads < 1) {
+        maxThreads = 1;
+    }
+    std::cout << "Threads | bookings/s | booked | rejected | overbooked slots" << std::endl;
+    for (int threadCount = 1; threadCount <= maxThreads * 2; threadCount *= 2) {
+        BookingStore* store = new BookingStore(index, doctorCount, 2);
+        std::atomic<long long> successes(0);
+        std::atomic<long long> failures(0);
+        std::thread* threads = new std::thread[threadCount];
+        auto begin = std::chrono::steady_clock::now();
+        for (int t = 0; t < threadCount; t++) {
+            threads[t] = std::thread([&, t]() { // [&] uses our locals by reference, "t" is copied
+                unsigned int state = 2463534242u + t * 7919u;
+                long long ok = 0;
+                long long rejected = 0;
+                for (int i = 0; i < requestsPerThread; i++) {
+                    unsigned int r = nextRandom(state);
+                    // a few popular hours, so that threads fight over the same slots and some of them fill up
+                    int doctor = store->book(benchmarkSpecialties[r % benchmarkSpecialtyCount], 1 + (int)((r >> 8) % 7), 8 + (int)((r >> 16) % 4));
+                    if (doctor != -1) {
+                        ok++;
+                    }
+                    else {
+                        rejected++;
+                    }
+                    if (doctor != -1 && (r >> 24) % 10 == 0) { // cancel some of them again
+                        store->cancel(doctor, 1 + (int)((r >> 8) % 7), 8 + (int)((r >> 16) % 4));
+                        ok--;
+                    }
+                }
+                successes += ok;
+                failures += rejected;
+            });
+        }
+        for (int t = 0; t < threadCount; t++) {
+            threads[t].join();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        long long total = 0;
+        int overbooked = 0;
+        for (int d = 0; d < doctorCount; d++) {
+            for (int day = 1; day <= 7; day++) {
+                for (int hour = 0; hour < 24; hour++) {
+                    int count = store->getBooked(d, day, hour);
+                    total += count;
+                    if (count > store->getCapacity()) {
+                        overbooked++;
+                    }
+                }
+            }
+        }
+        std::cout << threadCount << " | " << (long long)(threadCount * (long long)requestsPerThread / seconds) << " | " << total
+            << (total == successes.load() ? "" : " (MISMATCH)") << " | " << failures.load() << " | " << overbooked << std::endl;
+
+        delete[] threads;
+        delete store;
     }
+    delete[] doctors;
+}
 
-    Doctor(const std::string& n, const std::string* specs, int count, int day, int startHour, int endHour): 
-        specialties(nullptr), workingHoursStart(0), workingHoursEnd(23) { // parametrized constructor
-        // since we use setters and do validations on the parameters there with our parameters
-        // we have to give them some default values (so as to avoid comparisons with uninitialized memory)
-        this->setName(n);
-        this->setSpecialties(specs, count); // use setters to avoid code reuse
-        this->setPreferredWorkingDay(day);
-        this->setWorkingHoursStart(startHour);
-        this->setWorkingHoursEnd(endHour);
+struct AppointmentRequest { // "a patient wants a <specialty> doctor on <day>, any hour between <startHour> and <endHour>"
+    std::string specialty;
+    int day;
+    int startHour;
+    int endHour; // inclusive
+};
+
+AppointmentRequest* readRequests(const std::string& path, int& count, int& rejected) { // one "specialty day startHour endHour" per line
+    // returns nullptr if the file can't be opened; otherwise the caller must delete[] the result
+    count = rejected = 0;
+    std::ifstream file(path);
+    if (!file) {
+        std::cout << "Cannot open " << path << "!" << std::endl;
+        return nullptr;
+    }
+    int capacity = 1024;
+    AppointmentRequest* requests = new AppointmentRequest[capacity];
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        AppointmentRequest request;
+        if (!(fields >> request.specialty)) {
+            continue; // blank line
+        }
+        if (!(fields >> request.day >> request.startHour >> request.endHour) || request.day < 1 || request.day > 7 ||
+            request.startHour < 0 || request.endHour > 23 || request.startHour > request.endHour) {
+            rejected++;
+            continue;
+        }
+        if (count == capacity) {
+            AppointmentRequest* tmp = new AppointmentRequest[capacity * 2];
+            for (int i = 0; i < count; i++) {
+                tmp[i].specialty.swap(requests[i].specialty);
+                tmp[i].day = requests[i].day;
+                tmp[i].startHour = requests[i].startHour;
+                tmp[i].endHour = requests[i].endHour;
+            }
+            delete[] requests;
+            requests = tmp;
+            capacity *= 2;
+        }
+        requests[count++] = request;
     }
+    return requests;
+}
 
-    Doctor(const Doctor& other) { // copy constructor
-        // no need to validate other values, since we have an already constructed object which passed validations
-        // this one, being also a constructor, has the class's name
-        // it tells the program how we can initialize an object from an already existing one, rather than a list of parameters now
-        // the copy ctor is called explicitly when doing stuff like:
-        // "Doctor a; Doctor b(a);"
-        // or "Doctor b = Doctor(a);" (even though this one uses the assignment operator, since "b" is not already defined
-        // it does something called copy-initialization, and is equivalent to "Doctor b(a);", and no assignment is done, just copy)
-        // if "b" was already defined, doing "b = a" would result in using the assignment operator, which we haven't learned yet
-        // or implicitly, when passing/returning objects as value rather than reference
-        // by default, the copy ctor would do a bitwise copy of all of our attributes
-        // and therefore would shallow-copy the dynamic arrays
-        // hence, it is imperative that we define it when working with dynamic memory 
-        // (more on that later, when we learn operators and learn about the rule of three)
+class MaxFlow { // maximum flow with Dinic's algorithm
+    // edges are stored in arrays, each one followed by its reverse edge (so the reverse of edge e is e ^ 1);
+    // the reverse edge starts with 0 capacity and gains whatever flow is pushed through e, which is what lets the
+    // algorithm undo earlier choices: that is exactly what makes it beat assigning requests one by one
+private:
+    int nodeCount;
+    int* head; // first edge leaving each node (-1 = none), the rest are chained through "next"
+    int* level; // distance from the source in the current phase
+    int* current; // next edge to try from each node in the current phase, so dead ends are never visited twice
+    int* to;
+    int* next;
+    int* capacity; // remaining capacity of each edge
+    int edgeCount;
+    int edgeCapacity;
 
-        // it being a special function, and operating on objects of our type, the copy constructor can access private attributes
-        // without any special designation (more on that later, when we'll learn about friend classes)
-        this->name = other.name;
-        this->specialtyCount = other.specialtyCount;
+    void growEdges() {
+        int newCapacity = this->edgeCapacity * 2;
+        int* newTo = new int[newCapacity];
+        int* newNext = new int[newCapacity];
+        int* newCapacityArray = new int[newCapacity];
+        memcpy(newTo, this->to, sizeof(int) * this->edgeCount);
+        memcpy(newNext, this->next, sizeof(int) * this->edgeCount);
+        memcpy(newCapacityArray, this->capacity, sizeof(int) * this->edgeCount);
+        delete[] this->to;
+        delete[] this->next;
+        delete[] this->capacity;
+        this->to = newTo;
+        this->next = newNext;
+        this->capacity = newCapacityArray;
+        this->edgeCapacity = newCapacity;
+    }
 
-        if (this->specialtyCount > 0) {
-            this->specialties = new std::string[this->specialtyCount];
-            for (int i = 0; i < this->specialtyCount; i++) {
-                this->specialties[i] = other.specialties[i];
-            }
+    bool buildLevels(int source, int sink) { // breadth-first search over the edges with capacity left
+        for (int i = 0; i < this->nodeCount; i++) {
+            this->level[i] = -1;
         }
-        else {
-            this->specialties = nullptr;
+        int* queue = this->current; // not needed until the search is done, so we borrow it as the queue
+        int front = 0;
+        int back = 0;
+        queue[back++] = source;
+        this->level[source] = 0;
+        while (front < back) {
+            int node = queue[front++];
+            for (int e = this->head[node]; e != -1; e = this->next[e]) {
+                if (this->capacity[e] > 0 && this->level[this->to[e]] == -1) {
+                    this->level[this->to[e]] = this->level[node] + 1;
+                    queue[back++] = this->to[e];
+                }
+            }
         }
+        return this->level[sink] != -1;
+    }
 
-        this->preferredWorkingDay = other.preferredWorkingDay;
-        this->workingHoursStart = other.workingHoursStart;
-        this->workingHoursEnd = other.workingHoursEnd;
+    int push(int node, int sink, int amount) { // sends up to "amount" along edges going one level further, returns how much got through
+        if (node == sink) {
+            return amount;
+        }
+        int sent = 0;
+        for (int& e = this->current[node]; e != -1; e = this->next[e]) {
+            int target = this->to[e];
+            if (this->capacity[e] > 0 && this->level[target] == this->level[node] + 1) {
+                int pushed = this->push(target, sink, std::min(amount - sent, this->capacity[e]));
+                this->capacity[e] -= pushed;
+                this->capacity[e ^ 1] += pushed;
+                sent += pushed;
+                if (sent == amount) {
+                    return sent; // the edge might still have capacity, so we don't move past it
+                }
+            }
+        }
+        return sent;
     }
 
-    ~Doctor() {
-        delete[] this->specialties;
-        this->specialties = nullptr;
+public:
+    MaxFlow(int nodeCount) : nodeCount(nodeCount), edgeCount(0), edgeCapacity(1024) {
+        this->head = new int[nodeCount];
+        this->level = new int[nodeCount];
+        this->current = new int[nodeCount];
+        for (int i = 0; i < nodeCount; i++) {
+            this->head[i] = -1;
+        }
+        this->to = new int[this->edgeCapacity];
+        this->next = new int[this->edgeCapacity];
+        this->capacity = new int[this->edgeCapacity];
     }
 
-    std::string getName() const {
-        return this->name;
+    MaxFlow(const MaxFlow&) = delete;
+    MaxFlow& operator=(const MaxFlow&) = delete;
+
+    ~MaxFlow() {
+        delete[] this->head;
+        delete[] this->level;
+        delete[] this->current;
+        delete[] this->to;
+        delete[] this->next;
+        delete[] this->capacity;
     }
 
-    std::string* getSpecialties() const {
-        if (!this->specialtyCount || !this->specialties) { // ensure existence
-            return nullptr;
+    void addEdge(int from, int target, int edgeCapacity) {
+        if (this->edgeCount + 2 > this->edgeCapacity) {
+            this->growEdges();
         }
+        this->to[this->edgeCount] = target;
+        this->capacity[this->edgeCount] = edgeCapacity;
+        this->next[this->edgeCount] = this->head[from];
+        this->head[from] = this->edgeCount++;
+        this->to[this->edgeCount] = from; // the reverse edge
+        this->capacity[this->edgeCount] = 0;
+        this->next[this->edgeCount] = this->head[target];
+        this->head[target] = this->edgeCount++;
+    }
 
-        std::string* result = new std::string[this->specialtyCount]; // deep-copy
-        for (int i = 0; i < this->specialtyCount; i++) {
-            result[i] = this->specialties[i];
+    long long solve(int source, int sink) {
+        long long total = 0;
+        while (this->buildLevels(source, sink)) {
+            for (int i = 0; i < this->nodeCount; i++) {
+                this->current[i] = this->head[i];
+            }
+            int pushed;
+            while ((pushed = this->push(source, sink, 1 << 30)) > 0) {
+                total += pushed;
+            }
         }
+        return total;
+    }
 
-        return result; // beware: since we return a dynamic array here, the caller has the responsibility of cleaning it up
+    // walking the solution: even edges are the ones we added, their flow is what their reverse edge gained
+    int firstEdge(int node) const {
+        return this->head[node];
     }
 
-    int getSpecialtyCount() const {
-        return this->specialtyCount;
+    int nextEdge(int edge) const {
+        return this->next[edge];
     }
 
-    int getPreferredWorkingDay() const {
-        return this->preferredWorkingDay;
+    int getTarget(int edge) const {
+        return this->to[edge];
     }
 
-    int getWorkingHoursStart() const {
-        return this->workingHoursStart;
+    int getFlow(int edge) const {
+        return (edge & 1) ? 0 : this->capacity[edge ^ 1];
     }
 
-    int getWorkingHoursEnd() const {
-        return this->workingHoursEnd;
+    void takeFlow(int edge) { // removes one unit of flow from an edge (once it has been handed to a request)
+        this->capacity[edge ^ 1]--;
+        this->capacity[edge]++;
     }
 
-    void setName(const std::string& n) {
-        if (n.length() >= 3) {
-            this->name = n;
-        }
-        else {
-            std::cout << "Name length cannot be less than 3!" << std::endl;
-            this->name = ""; // give a default value
-        }
-        
+    int getEdgeCount() const {
+        return this->edgeCount;
     }
+};
 
-    void setSpecialties(const std::string* specs, int count) {
-        if (this->specialties) { // clear before re-allocation
-            delete[] this->specialties;
+class BatchScheduler { // assigns a whole batch of requests at once, so that as many as possible get a doctor
+    // first-fit gives every request the first free slot it finds, which can take the only slot a later request could have used;
+    // instead we solve it as a maximum flow through the layers
+    //   source -> request type -> (specialty, day, hour) -> (doctor, day, hour) -> sink
+    // identical requests are merged into one "type" node (source edge capacity = how many of them there are), an hour node
+    // links to the doctors who have that specialty and work then, and a doctor's slot lets through only the places
+    // still free in the booking store; merging keeps the graph small enough for 10^5 requests against 10^5 doctors
+public:
+    static int solve(const SchedulingIndex& index, BookingStore& store, const AppointmentRequest* requests, int count,
+        int* assignedDoctor, int* assignedHour, int& edges) { // returns how many got a doctor (and books them in the store)
+        // assignedDoctor/assignedHour get the doctor id and hour of each request, or -1 for those left without one
+        std::chrono::steady_clock::time_point start = SchedulingStats::start();
+        const int slots = 7 * 24;
+        int specialtyCount = 0;
+        int* specialtyOf = new int[count > 0 ? count : 1];
+        for (int i = 0; i < count; i++) {
+            specialtyOf[i] = index.getSpecialtyId(requests[i].specialty);
+            specialtyCount = std::max(specialtyCount, specialtyOf[i] + 1);
+            assignedDoctor[i] = assignedHour[i] = -1;
         }
 
-        if (count > 0 && specs != nullptr) {
-            this->specialtyCount = count;
-            this->specialties = new std::string[count]; // since strings are a special container, we cannot use memcpy directly
-            // because we cannot determine the size with simple calculations involving sizeof
-            for (int i = 0; i < count; i++) {
-                this->specialties[i] = specs[i];
-            }
+        // request types: (specialty, day, start, end)
+        const int windows = 7 * 24 * 24;
+        int* typeOfKey = new int[specialtyCount * windows > 0 ? specialtyCount * windows : 1];
+        for (int i = 0; i < specialtyCount * windows; i++) {
+            typeOfKey[i] = -1;
         }
-        else {
-            std::cout << "Count cannot be less than 1 or the array cannot be null!" << std::endl;
-            this->specialtyCount = 0;
-            this->specialties = nullptr;
+        int* typeOf = new int[count > 0 ? count : 1];
+        int* typeKey = new int[count > 0 ? count : 1];
+        int* typeSize = new int[count > 0 ? count : 1];
+        int typeCount = 0;
+        for (int i = 0; i < count; i++) {
+            typeOf[i] = -1;
+            if (specialtyOf[i] == -1) {
+                continue; // nobody has this specialty
+            }
+            int key = specialtyOf[i] * windows + (requests[i].day - 1) * 576 + requests[i].startHour * 24 + requests[i].endHour;
+            if (typeOfKey[key] == -1) {
+                typeOfKey[key] = typeCount;
+                typeKey[typeCount] = key;
+                typeSize[typeCount++] = 0;
+            }
+            typeOf[i] = typeOfKey[key];
+            typeSize[typeOf[i]]++;
         }
-    }
 
-    void setPreferredWorkingDay(int d) {
-        if (d < 1) {
-            std::cout << "Day cannot be less than 1 (Monday)!" << std::endl;
-            d = 1;
+        // hour nodes used by at least one type, and the (doctor, day, hour) slots behind them
+        int* hourNode = new int[specialtyCount * slots > 0 ? specialtyCount * slots : 1];
+        for (int i = 0; i < specialtyCount * slots; i++) {
+            hourNode[i] = -1;
         }
-        if (d > 7) {
-            std::cout << "Day cannot be bigger than 7 (Sunday)!" << std::endl;
-            d = 7;
+        int hourCount = 0;
+        int slotKeyCount = 0;
+        for (int t = 0; t < typeCount; t++) {
+            int specialty = typeKey[t] / windows;
+            int day = (typeKey[t] % windows) / 576 + 1;
+            for (int hour = (typeKey[t] % 576) / 24; hour <= typeKey[t] % 24; hour++) {
+                int key = specialty * slots + (day - 1) * 24 + hour;
+                if (hourNode[key] == -1) {
+                    hourNode[key] = hourCount++;
+                    int doctors;
+                    index.findAll(specialty, day, hour, doctors);
+                    slotKeyCount += doctors;
+                }
+            }
         }
-        this->preferredWorkingDay = d;
-    }
+        int* slotKeys = new int[slotKeyCount > 0 ? slotKeyCount : 1]; // doctor * 168 + (day - 1) * 24 + hour, sorted and without duplicates
+        int filled = 0;
+        for (int key = 0; key < specialtyCount * slots; key++) {
+            if (hourNode[key] != -1) {
+                int doctors;
+                const int* found = index.findAll(key / slots, key % slots / 24 + 1, key % 24, doctors);
+                for (int i = 0; i < doctors; i++) {
+                    slotKeys[filled++] = found[i] * slots + key % slots;
+                }
+            }
+        }
+        std::sort(slotKeys, slotKeys + filled);
+        int slotCount = (int)(std::unique(slotKeys, slotKeys + filled) - slotKeys); // a doctor with 2 matching specialties appears twice
 
-    void setWorkingHoursStart(int h) {
-        if (h < 0) {
-            std::cout << "Hour cannot be less than 0!" << std::endl;
-            h = 0;
+        // nodes: 0 = source, 1 = sink, then the types, the hours and the slots
+        const int source = 0;
+        const int sink = 1;
+        const int firstType = 2;
+        const int firstHour = firstType + typeCount;
+        const int firstSlot = firstHour + hourCount;
+        MaxFlow flow(firstSlot + slotCount);
+        for (int t = 0; t < typeCount; t++) {
+            flow.addEdge(source, firstType + t, typeSize[t]);
+            int specialty = typeKey[t] / windows;
+            int day = (typeKey[t] % windows) / 576 + 1;
+            for (int hour = (typeKey[t] % 576) / 24; hour <= typeKey[t] % 24; hour++) {
+                flow.addEdge(firstType + t, firstHour + hourNode[specialty * slots + (day - 1) * 24 + hour], typeSize[t]);
+            }
         }
-        if (h > 23) {
-            std::cout << "Hour cannot be bigger than 23!" << std::endl;
-            h = 23;
+        for (int key = 0; key < specialtyCount * slots; key++) {
+            if (hourNode[key] != -1) {
+                int doctors;
+                const int* found = index.findAll(key / slots, key % slots / 24 + 1, key % 24, doctors);
+                for (int i = 0; i < doctors; i++) {
+                    int slot = (int)(std::lower_bound(slotKeys, slotKeys + slotCount, found[i] * slots + key % slots) - slotKeys);
+                    flow.addEdge(firstHour + hourNode[key], firstSlot + slot, 1 << 30);
+                }
+            }
         }
-        if (h >= this->workingHoursEnd) {
-            h = this->workingHoursEnd - 1;
-            std::cout << "Start hour cannot be bigger than or equal to the end hour!" << std::endl;
+        for (int i = 0; i < slotCount; i++) {
+            int doctor = slotKeys[i] / slots;
+            int day = slotKeys[i] % slots / 24 + 1;
+            int hour = slotKeys[i] % 24;
+            int free = store.getCapacity() - store.getBooked(doctor, day, hour);
+            if (free > 0) {
+                flow.addEdge(firstSlot + i, sink, free);
+            }
         }
-        this->workingHoursStart = h;
-    }
+        edges = flow.getEdgeCount() / 2;
 
-    void setWorkingHoursEnd(int h) {
-        if (h < 0) {
-            std::cout << "Hour cannot be less than 0!" << std::endl;
-            h = 0;
-        }
-        if (h > 23) {
-            std::cout << "Hour cannot be bigger than 23!" << std::endl;
-            h = 23;
+        flow.solve(source, sink);
+
+        // hand the flow out to the requests: every unit leaving a type node goes through one hour node to one slot
+        int* cursor = new int[firstSlot]; // the next edge worth looking at, for every type and hour node
+        for (int node = 0; node < firstSlot; node++) {
+            cursor[node] = flow.firstEdge(node);
         }
-        if (h <= this->workingHoursStart) {
-            h = this->workingHoursStart + 1;
-            std::cout << "End hour cannot be smaller than or equal to the start hour!" << std::endl;
+        int assigned = 0;
+        for (int i = 0; i < count; i++) {
+            if (typeOf[i] == -1) {
+                continue;
+            }
+            int node = firstType + typeOf[i];
+            int& e = cursor[node];
+            while (e != -1 && flow.getFlow(e) == 0) {
+                e = flow.nextEdge(e);
+            }
+            if (e == -1) {
+                continue; // every unit of this type has been handed out, so this request stays without a doctor
+            }
+            flow.takeFlow(e);
+            int hourEdgeNode = flow.getTarget(e);
+            int& h = cursor[hourEdgeNode];
+            while (flow.getFlow(h) == 0) { // flow in = flow out, so there is always one
+                h = flow.nextEdge(h);
+            }
+            flow.takeFlow(h);
+            int slotKey = slotKeys[flow.getTarget(h) - firstSlot];
+            assignedDoctor[i] = slotKey / slots;
+            assignedHour[i] = slotKey % 24;
+            store.reserve(assignedDoctor[i], requests[i].day, assignedHour[i]);
+            assigned++;
         }
-        this->workingHoursEnd = h;
+
+        delete[] cursor;
+        delete[] slotKeys;
+        delete[] hourNode;
+        delete[] typeSize;
+        delete[] typeKey;
+        delete[] typeOf;
+        delete[] typeOfKey;
+        delete[] specialtyOf;
+        SchedulingStats::instance().batches.record(start, assigned > 0, slotCount); // the candidates are the doctor slots in the graph
+        return assigned;
     }
 
-    bool hasSpecialty(const std::string& s) const {
-        for (int i = 0; i < this->specialtyCount; i++) {
-            if (this->specialties[i] == s) {
-                return true;
+    static int solveGreedy(BookingStore& store, const AppointmentRequest* requests, int count) { // one by one, first free hour
+        int assigned = 0;
+        for (int i = 0; i < count; i++) {
+            for (int hour = requests[i].startHour; hour <= requests[i].endHour; hour++) {
+                if (store.book(requests[i].specialty, requests[i].day, hour) != -1) {
+                    assigned++;
+                    break;
+                }
             }
         }
-        return false;
+        return assigned;
     }
+};
+
+void runBatch(const SchedulingIndex& index, BookingStore& store, const AppointmentRequest* requests, int count) {
+    int* doctors = new int[count > 0 ? count : 1];
+    int* hours = new int[count > 0 ? count : 1];
+    int edges;
+    auto begin = std::chrono::steady_clock::now();
+    int assigned = BatchScheduler::solve(index, store, requests, count, doctors, hours, edges);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << "Assigned " << assigned << "/" << count << " requests (" << (count ? 100.0 * assigned / count : 0) << "%) in "
+        << seconds * 1000 << " ms (" << edges << " edges)" << std::endl;
+    delete[] doctors;
+    delete[] hours;
+}
+
+void runBatchBenchmark() { // flow vs first-fit, on more requests than there are free places
+    const int doctorCount = 10000;
+    const int requestCount = 100000;
+    Doctor* doctors = generateDoctors(doctorCount);
+    SchedulingIndex index;
+    index.build(doctors, doctorCount);
 
-    bool worksAt(int day, int hour) const {
-        return day == this->preferredWorkingDay && hour >= this->workingHoursStart && hour <= this->workingHoursEnd;
+    unsigned int state = 362436069u;
+    AppointmentRequest* requests = new AppointmentRequest[requestCount];
+    for (int i = 0; i < requestCount; i++) {
+        unsigned int r = nextRandom(state);
+        requests[i].specialty = benchmarkSpecialties[r % benchmarkSpecialtyCount];
+        requests[i].day = 1 + (int)((r >> 8) % 7);
+        requests[i].startHour = 6 + (int)((r >> 12) % 12);
+        requests[i].endHour = std::min(23, requests[i].startHour + (int)((r >> 20) % 4));
     }
 
-    void print() const {
-        std::cout << "Doctor: " << this->name << std::endl;
-        std::cout << "Specialties: ";
-        if (this->specialties) {
-            for (int i = 0; i < this->specialtyCount; i++) {
-                std::cout << this->specialties[i];
-                if (i < this->specialtyCount - 1) {
-                    std::cout << ", ";
+    BookingStore* store = new BookingStore(index, doctorCount, 2);
+    runBatch(index, *store, requests, requestCount);
+    delete store;
+
+    store = new BookingStore(index, doctorCount, 2);
+    auto begin = std::chrono::steady_clock::now();
+    int greedy = BatchScheduler::solveGreedy(*store, requests, requestCount);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << "First-fit: " << greedy << "/" << requestCount << " requests (" << 100.0 * greedy / requestCount << "%) in "
+        << seconds * 1000 << " ms" << std::endl;
+    delete store;
+
+    delete[] requests;
+    delete[] doctors;
+}
+
+void runRosterBenchmark() { // counts the allocations needed to build a 1M doctor roster, with copies and with moves/emplace
+    const int doctorCount = 1000000;
+    const std::string specs[2] = { "Cardiology", "Intensivist" };
+    std::cout << "Method | allocations | time (ms)" << std::endl;
+
+    long long before = allocationCount.load();
+    auto begin = std::chrono::steady_clock::now();
+    Doctor* array = new Doctor[doctorCount]; // the old way: default doctors, then each one overwritten by a copy
+    for (int i = 0; i < doctorCount; i++) {
+        Doctor doctor("Generated doctor number " + std::to_string(i), specs, 2, 1 + i % 7, 8, 16);
+        array[i] = doctor; // copy assignment
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << "array + copies | " << allocationCount.load() - before << " | " << seconds * 1000 << std::endl;
+    delete[] array;
+
+    before = allocationCount.load();
+    begin = std::chrono::steady_clock::now();
+    {
+        DoctorRoster roster; // no reserve: it grows (moving the doctors) as it goes
+        for (int i = 0; i < doctorCount; i++) {
+            roster.emplace(Doctor("Generated doctor number " + std::to_string(i), specs, 2, 1 + i % 7, 8, 16)); // move constructor
+        }
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        std::cout << "roster + moves | " << allocationCount.load() - before << " | " << seconds * 1000 << std::endl;
+    }
+
+    before = allocationCount.load();
+    begin = std::chrono::steady_clock::now();
+    {
+        DoctorRoster roster;
+        roster.reserve(doctorCount);
+        for (int i = 0; i < doctorCount; i++) {
+            roster.emplace("Generated doctor number " + std::to_string(i), specs, 2, 1 + i % 7, 8, 16); // built in place
+        }
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        std::cout << "reserved roster + emplace | " << allocationCount.load() - before << " | " << seconds * 1000 << std::endl;
+    }
+    // std::to_string + the concatenation cost 1 allocation per doctor (the name itself), which no method can avoid
+}
+
+void runSnapshotBenchmark() { // saves a 1M doctor roster, then opens it again and compares with building it doctor by doctor
+    const int doctorCount = 1000000;
+    const std::string path = "benchmark.roster";
+    Doctor* doctors = generateDoctors(doctorCount);
+
+    auto begin = std::chrono::steady_clock::now();
+    bool saved = saveRoster(path, doctors, doctorCount);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    if (!saved) {
+        delete[] doctors;
+        return;
+    }
+    std::cout << "Saved " << doctorCount << " doctors in " << seconds * 1000 << " ms" << std::endl;
+
+    RosterSnapshot snapshot;
+    begin = std::chrono::steady_clock::now();
+    bool opened = snapshot.open(path);
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::cout << "Opened (mapped + checked) in " << seconds * 1000 << " ms" << std::endl;
+
+    if (opened) {
+        int mismatches = 0;
+        for (int d = 0; d < doctorCount; d += 997) {
+            Doctor doctor = snapshot.getDoctor(d);
+            if (doctor.getName() != doctors[d].getName() || doctor.getSpecialtyMask() != doctors[d].getSpecialtyMask() ||
+                doctor.getAvailability().getCount() != doctors[d].getAvailability().getCount()) {
+                mismatches++;
+            }
+        }
+        std::cout << "Sampled doctors differing from the originals: " << mismatches << std::endl;
+
+        // what the program does: open the snapshot at startup, and build both indexes straight from its records when first needed
+        {
+            LazyRoster lazy;
+            SchedulingIndex index;
+            ScheduleTree tree;
+            long long allocations = allocationCount.load();
+            begin = std::chrono::steady_clock::now();
+            lazy.open(path);
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            std::cout << "Startup from the snapshot (no Doctor objects) in " << seconds * 1000 << " ms" << std::endl;
+            begin = std::chrono::steady_clock::now();
+            index.buildFrom(lazy, lazy.getSize());
+            tree.buildFrom(lazy, lazy.getSize());
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            std::cout << "Both indexes built from its records (on the first scheduling option) in " << seconds * 1000 << " ms ("
+                << allocationCount.load() - allocations << " allocations)" << std::endl;
+
+            SchedulingIndex fromDoctors; // the same index built from the original doctors must give the same answers
+            fromDoctors.build(doctors, doctorCount);
+            int differing = 0;
+            for (int s = 0; s < benchmarkSpecialtyCount; s++) {
+                int id = SpecialtyRegistry::instance().find(benchmarkSpecialties[s]);
+                for (int slot = 0; slot < 7 * 24; slot += 5) {
+                    int lazyCount;
+                    int doctorsCount;
+                    const int* lazyFound = index.findAll(id, 1 + slot / 24, slot % 24, lazyCount);
+                    const int* doctorsFound = fromDoctors.findAll(id, 1 + slot / 24, slot % 24, doctorsCount);
+                    if (lazyCount != doctorsCount || (lazyCount && memcmp(lazyFound, doctorsFound, sizeof(int) * lazyCount) != 0)) {
+                        differing++;
+                    }
                 }
             }
+            std::cout << "Index lookups differing from an index built from the doctors: " << differing << std::endl;
         }
-        else {
-            std::cout << "(None)";
+
+        DoctorRoster roster;
+        long long allocations = allocationCount.load();
+        begin = std::chrono::steady_clock::now();
+        snapshot.loadInto(roster);
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        std::cout << "For comparison, building all the Doctor objects from it takes " << seconds * 1000 << " ms (" << allocationCount.load() - allocations
+            << " allocations)" << std::endl;
+    }
+    delete[] doctors;
+    std::remove(path.c_str());
+}
+
+class Scheduler { // the indexes and the appointments over the program's doctors, built the first time something needs them
+    // so that opening a big roster (a snapshot is only mapped) stays fast, and the indexes are built only if we schedule at all
+private:
+    const LazyRoster& doctors;
+    SchedulingIndex index;
+    ScheduleTree freeTimes;
+    BookingStore* bookings; // nullptr until first needed
+    bool indexesBuilt;
+
+    void prepare() {
+        if (!this->indexesBuilt) {
+            // straight from the roster, which reads the snapshot's records for the doctors not built yet
+            this->index.buildFrom(this->doctors, this->doctors.getSize());
+            this->freeTimes.buildFrom(this->doctors, this->doctors.getSize());
+            this->indexesBuilt = true;
         }
-        std::cout << std::endl << "Preferred day: " << this->preferredWorkingDay << std::endl;
-        std::cout << "Working hours: " << this->workingHoursStart << "-" << this->workingHoursEnd << std::endl;
+        if (!this->bookings) {
+            this->bookings = new BookingStore(this->index, this->doctors.getSize(), 2); // every doctor can see 2 patients per hour
+        }
+    }
+
+public:
+    Scheduler(const LazyRoster& doctors) : doctors(doctors), bookings(nullptr), indexesBuilt(false) {}
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    ~Scheduler() {
+        delete this->bookings;
+        this->bookings = nullptr;
+    }
+
+    const SchedulingIndex& getIndex() {
+        this->prepare();
+        return this->index;
+    }
+
+    const ScheduleTree& getFreeTimes() {
+        this->prepare();
+        return this->freeTimes;
+    }
+
+    BookingStore& getBookings() {
+        this->prepare();
+        return *this->bookings;
+    }
+
+    void schedulesChanged() { // a doctor's hours changed: the indexes get rebuilt, the appointments already made are kept
+        this->indexesBuilt = false;
+    }
+
+    void doctorsReplaced() { // a whole new set of doctors: the appointments were for the old ones
+        this->indexesBuilt = false;
+        delete this->bookings;
+        this->bookings = nullptr;
     }
 };
 
 int main() {
-    std::string* cardio = new std::string[2]; // use dynamic arrays
-    // since our class uses dynamic arrays, we have to also use dynamic arrays to initialize it
-    // had we used static arrays, when an object would be destroyed, the program would attempt to delete static memory
-    // resulting in a crash
-    cardio[0] = "Cardiology";
-    cardio[1] = "Intensivist";
-
-    std::string* derm = new std::string[1];
-    derm[0] = "Dermatology";
-
-    std::string* neuro = new std::string[3];
-    neuro[0] = "Neurology";
-    neuro[1] = "Psychiatry";
-    neuro[2] = "Neurosurgery";
-
-    Doctor doctors[10] = { // declare our doctors array
-        Doctor("John Smith", cardio, 2, 2, 8, 16),
-        Doctor("Donna Noble", derm, 1, 3, 10, 18),
-        Doctor("Rose Taylor", neuro, 2, 4, 9, 17),
-        Doctor("Sarah Jane Smith", derm, 1, 1, 7, 15),
-        Doctor("Kate Stewart", cardio, 2, 5, 6, 14),
-        // use copy constructor to initialize new objects
-        Doctor(doctors[0]),
-        Doctor(doctors[1]),
-        Doctor(doctors[2]),
-        Doctor(doctors[3]),
-        Doctor(doctors[4]),
-    };
-    // using doctors[5] = Doctor(doctors[0]); here instead of defining it in the array, 
-    // would result in using the assignment operator (since doctors[5] would be already initialized with the default constructor)
-    // which would create a shallow-copy of our object, which we do not want
-    doctors[5].setName("John Smith Jr.");
-    doctors[6].setName("Donna Noble Jr.");
-    doctors[7].setName("Rose Taylor Jr.");
-    doctors[8].setName("Sarah Jane Smith Jr.");
-    doctors[9].setName("Kate Stewart Jr.");
-
-    // cleanup for our dynamic arrays
-    // safe since copies have been already made
-    delete[] cardio;
-    cardio = nullptr;
-    delete[] derm;
-    derm = nullptr;
-    delete[] neuro;
-    neuro = nullptr;
+    // the doctors only keep the ids of these names (the registry keeps one copy of each), so plain static arrays are enough
+    const std::string cardio[2] = { "Cardiology", "Intensivist" };
+    const std::string derm[1] = { "Dermatology" };
+    const std::string neuro[3] = { "Neurology", "Psychiatry", "Neurosurgery" };
+
+    LazyRoster doctors; // declare our doctors roster
+    const std::string rosterPath = "doctors.roster";
+    if (doctors.open(rosterPath)) { // a roster saved earlier (option 11) wins over the built-in doctors
+        // the doctors stay in the mapped file: the indexes below are built from its records, and no Doctor is created yet
+        std::cout << "Loaded " << doctors.getSize() << " doctors from " << rosterPath << std::endl;
+    }
+    else {
+        DoctorRoster& roster = doctors.getRoster();
+        roster.reserve(10);
+        // emplace passes the arguments straight to the constructor, which builds the doctor inside the roster (no temporary to copy)
+        roster.emplace("John Smith", cardio, 2, 2, 8, 16);
+        roster.emplace("Donna Noble", derm, 1, 3, 10, 18);
+        roster.emplace("Rose Taylor", neuro, 2, 4, 9, 17);
+        roster.emplace("Sarah Jane Smith", derm, 1, 1, 7, 15);
+        roster.emplace("Kate Stewart", cardio, 2, 5, 6, 14);
+        for (int i = 0; i < 5; i++) {
+            roster.emplace(roster[i]); // a Doctor argument picks the copy constructor
+        }
+        roster[5].setName("John Smith Jr.");
+        roster[6].setName("Donna Noble Jr.");
+        roster[7].setName("Rose Taylor Jr.");
+        roster[8].setName("Sarah Jane Smith Jr.");
+        roster[9].setName("Kate Stewart Jr.");
+    }
+
+    Scheduler scheduler(doctors); // the indexes are built on the first scheduling option, and again whenever the doctors change
 
     while (true) {
         std::cout << "1. List all doctors" << std::endl;
         std::cout << "2. Schedule appointment" << std::endl;
-        std::cout << "3. Exit" << std::endl;
+        std::cout << "3. Cancel appointment" << std::endl;
+        std::cout << "4. Benchmark scheduling index" << std::endl;
+        std::cout << "5. Benchmark concurrent booking" << std::endl;
+        std::cout << "6. Batch schedule from file" << std::endl;
+        std::cout << "7. Benchmark batch scheduling" << std::endl;
+        std::cout << "8. Benchmark roster allocations" << std::endl;
+        std::cout << "9. Find free doctors (minute precision)" << std::endl;
+        std::cout << "10. Add time off" << std::endl;
+        std::cout << "11. Save roster" << std::endl;
+        std::cout << "12. Load roster" << std::endl;
+        std::cout << "13. Benchmark roster snapshot" << std::endl;
+        std::cout << "14. Dump scheduling stats (JSON)" << std::endl;
+        std::cout << "15. Reset scheduling stats" << std::endl;
+        std::cout << "16. Turn scheduling stats " << (SchedulingStats::instance().isEnabled() ? "off" : "on") << std::endl;
+        std::cout << "17. Exit" << std::endl;
         std::cout << "Choose option: ";
 
         int option;
         std::cin >> option;
 
         if (option == 1) {
-            for (int i = 0; i < 10; i++) {
-                doctors[i].print();
+            for (int i = 0; i < doctors.getSize(); i++) {
+                doctors.print(i);
             }
         }
         else if (option == 2) {
@@ -283,22 +2998,151 @@ int main() {
             std::cout << "Hour (0-23): ";
             std::cin >> hour;
 
-            bool found = false;
-
-            for (int i = 0; i < 10; i++) {
-                if (doctors[i].hasSpecialty(spec) && doctors[i].worksAt(day, hour)) {
-                    std::cout << "Appointment scheduled with: " << std::endl;
-                    doctors[i].print();
-                    found = true;
-                    break;
-                }
+            BookingStore& bookings = scheduler.getBookings();
+            int found = bookings.book(spec, day, hour); // the matching doctor with the fewest appointments, who still has room
+            if (found != -1) {
+                std::cout << "Appointment scheduled with (doctor #" << found + 1 << "): " << std::endl;
+                doctors.print(found);
+                std::cout << "Booked at that hour: " << bookings.getBooked(found, day, hour) << "/" << bookings.getCapacity() << std::endl;
             }
-
-            if (!found) {
+            else if (scheduler.getIndex().findFirst(spec, day, hour) != -1) {
+                std::cout << "All doctors are fully booked at that hour!" << std::endl;
+            }
+            else {
                 std::cout << "No doctor available!" << std::endl;
             }
         }
         else if (option == 3) {
+            int number;
+            int day;
+            int hour;
+            std::cout << "Doctor number (1-" << doctors.getSize() << "): ";
+            std::cin >> number;
+            std::cout << "Day (1-7): ";
+            std::cin >> day;
+            std::cout << "Hour (0-23): ";
+            std::cin >> hour;
+            if (scheduler.getBookings().cancel(number - 1, day, hour)) {
+                std::cout << "Appointment cancelled!" << std::endl;
+            }
+            else {
+                std::cout << "No appointment to cancel!" << std::endl;
+            }
+        }
+        else if (option == 4) {
+            runSchedulingBenchmark();
+        }
+        else if (option == 5) {
+            runBookingBenchmark();
+        }
+        else if (option == 6) {
+            std::string path;
+            std::cout << "Requests file (one \"specialty day startHour endHour\" per line): ";
+            std::cin >> path;
+            int count;
+            int rejected;
+            AppointmentRequest* requests = readRequests(path, count, rejected);
+            if (requests) {
+                if (rejected) {
+                    std::cout << "Skipped " << rejected << " invalid lines" << std::endl;
+                }
+                runBatch(scheduler.getIndex(), scheduler.getBookings(), requests, count);
+                delete[] requests;
+            }
+        }
+        else if (option == 7) {
+            runBatchBenchmark();
+        }
+        else if (option == 8) {
+            runRosterBenchmark();
+        }
+        else if (option == 9) {
+            std::string spec;
+            int day;
+            int startHour, startMinute, endHour, endMinute;
+            char colon;
+            std::cout << "Specialty ('-' for any): ";
+            std::cin >> spec;
+            std::cout << "Day (1-7): ";
+            std::cin >> day;
+            std::cout << "From (HH:MM): ";
+            std::cin >> startHour >> colon >> startMinute;
+            std::cout << "To (HH:MM): ";
+            std::cin >> endHour >> colon >> endMinute;
+            int specialtyId = spec == "-" ? -1 : SpecialtyRegistry::instance().find(spec);
+            if (day < 1 || day > 7 || (spec != "-" && specialtyId == -1)) {
+                std::cout << "No doctor available!" << std::endl;
+                continue;
+            }
+            int* found = new int[doctors.getSize()];
+            int count = scheduler.getFreeTimes().findFree(minuteOfWeek(day, startHour, startMinute), minuteOfWeek(day, endHour, endMinute), specialtyId,
+                found, doctors.getSize());
+            if (!count) {
+                std::cout << "No doctor available!" << std::endl;
+            }
+            for (int i = 0; i < count; i++) {
+                std::cout << "Free: " << doctors.getName(found[i]) << " (doctor #" << found[i] + 1 << ")" << std::endl;
+            }
+            delete[] found;
+        }
+        else if (option == 10) {
+            int number;
+            int day;
+            int startHour, startMinute, endHour, endMinute;
+            char colon;
+            std::cout << "Doctor number (1-" << doctors.getSize() << "): ";
+            std::cin >> number;
+            std::cout << "Day (1-7): ";
+            std::cin >> day;
+            std::cout << "From (HH:MM): ";
+            std::cin >> startHour >> colon >> startMinute;
+            std::cout << "To (HH:MM, 24:00 for the end of the day): ";
+            std::cin >> endHour >> colon >> endMinute;
+            if (number < 1 || number > doctors.getSize() || day < 1 || day > 7) {
+                std::cout << "Invalid doctor or day!" << std::endl;
+                continue;
+            }
+            doctors.edit(number - 1).addTimeOff(minuteOfWeek(day, startHour, startMinute), minuteOfWeek(day, endHour, endMinute));
+            scheduler.schedulesChanged(); // both indexes are built from the schedules, so they have to be rebuilt
+            doctors.print(number - 1);
+        }
+        else if (option == 11) {
+            // saving needs every doctor; building them also closes the snapshot, which may be the very file we overwrite
+            if (saveRoster(rosterPath, doctors.getRoster().getDoctors(), doctors.getSize())) {
+                std::cout << "Saved " << doctors.getSize() << " doctors to " << rosterPath << std::endl;
+            }
+        }
+        else if (option == 12) {
+            std::string path;
+            std::cout << "Roster file: ";
+            std::cin >> path;
+            if (!doctors.open(path)) {
+                std::cout << "Cannot load " << path << "!" << std::endl;
+                continue;
+            }
+            scheduler.doctorsReplaced();
+            std::cout << "Loaded " << doctors.getSize() << " doctors" << std::endl;
+        }
+        else if (option == 13) {
+            runSnapshotBenchmark();
+        }
+        else if (option == 14) {
+            const std::string statsPath = "scheduling_stats.json";
+            SchedulingStats::instance().writeJson(std::cout, doctors.getSize());
+            std::ofstream statsFile(statsPath);
+            if (statsFile) {
+                SchedulingStats::instance().writeJson(statsFile, doctors.getSize());
+                std::cout << "(also written to " << statsPath << ")" << std::endl;
+            }
+        }
+        else if (option == 15) {
+            SchedulingStats::instance().reset();
+            std::cout << "Stats reset!" << std::endl;
+        }
+        else if (option == 16) {
+            SchedulingStats::instance().setEnabled(!SchedulingStats::instance().isEnabled());
+        }
+        else if (option == 17) {
             std::cout << "Goodbye!" << std::endl;
             break;
         }
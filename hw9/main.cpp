@@ -1,565 +1,2860 @@
 #define _CRT_SECURE_NO_WARNINGS
 #include <iostream>
 #include <cstring>
+#include <string>
+#include <chrono>
+#include <utility>
+#include <atomic>
+#include <new>
+#include <cstdlib>
+#include <thread> // for std::thread
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h> // for _addcarry_u64 and _subborrow_u64 (used by FixedInt)
+#elif defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+// every allocation in the program goes through "operator new", so by replacing it we can count them (used by the allocation benchmark)
+static std::atomic<long long> allocationCount(0);
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    void* memory = std::malloc(size ? size : 1);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete" // GCC doesn't see that our new/delete are a matching pair
+#endif
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+void operator delete(void* memory, std::size_t) noexcept { // the "sized" version, used by delete when the size is known
+    ::operator delete(memory);
+}
+
+class StringAsNumber {
+    // the number is not kept as a string anymore, but in binary, as "limbs" - 32-bit pieces which act like the digits of
+    // the number written in base 2^32 (just like 123 = 1 * 10^2 + 2 * 10^1 + 3 * 10^0, we have x = limbs[n-1] * (2^32)^(n-1) + ... + limbs[0])
+    // the limbs go from the least significant one (limbs[0]) to the most significant one, so carries move to the right in memory
+    // this way, one machine operation handles ~9.6 decimal digits at once, instead of one character (and one "- '0'") per digit,
+    // and the number takes ~2.4x less memory than its decimal string
+    // the decimal string is only parsed in the constructor and only built when printing, so from the outside nothing changes
+    // we use 32-bit limbs (and not 64-bit ones) since the product of two of them always fits in an unsigned long long,
+    // on every compiler and platform (including 32-bit Windows)
+    // small numbers (up to 4 limbs = 128 bits, ~38 digits) are kept inside the object itself, so they never touch the heap
+    // the modular arithmetic classes below work directly on the limbs, so they are friends
+    friend class MontgomeryContext;
+    friend class BarrettReducer;
+    template <int Bits> friend class FixedInt;
+
+    private:
+        typedef unsigned int Limb;
+        typedef unsigned long long DoubleLimb;
+        static const int LIMB_BITS = 32;
+        static const Limb DECIMAL_CHUNK = 1000000000; // 10^9, the biggest power of 10 that fits in a limb
+        static const int DECIMAL_CHUNK_DIGITS = 9;
+        static const int INLINE_LIMBS = 4;
+        static const int SMALL_SCRATCH = 16; // temporary arrays up to this many limbs are kept on the stack
+        static const int KARATSUBA_DEFAULT = 32;
+        static const int TOOM3_DEFAULT = 300;
+        static const int NTT_DEFAULT = 4000;
+        static const int NEWTON_DEFAULT = 2000;
+        static const int RECIPROCAL_BASE_CASE = 16; // reciprocals up to this many limbs are computed with a plain division
+        static const int NTT_MAX_LENGTH = 1 << 23; // the longest transform all 3 primes below support (998244353 = 119 * 2^23 + 1)
+        static const Limb NTT_PRIME1 = 998244353;
+        static const Limb NTT_PRIME2 = 167772161;
+        static const Limb NTT_PRIME3 = 469762049;
+        // decimal conversion splits numbers in two (around a power of 10) until they have at most this many limbs,
+        // and converts those pieces 9 digits at a time
+        static const int DECIMAL_SPLIT_LIMBS = 40;
+        static const int DECIMAL_POWER_LEVELS = 28; // 10^(9 * 2^27) has more digits than a std::string can hold anyway
+        // printing divides by the powers of 10 with their (cached) reciprocals from this size on, and with long division below it
+        static const int DECIMAL_RECIPROCAL_LIMBS = 64;
+
+        // above these sizes (in limbs, of the smaller operand), multiplication switches from the school algorithm
+        // to Karatsuba, from Karatsuba to Toom-3 and from Toom-3 to the NTT; tuneMultiplication() (below the class) measures
+        // where that pays off
+        static int karatsubaThreshold;
+        static int toom3Threshold;
+        static int nttThreshold;
+        // division uses Newton's method (a reciprocal and two multiplications) instead of long division once
+        // both the divisor and the quotient have at least this many limbs
+        static int newtonThreshold;
+        // decimalPowers[i] = 10^(9 * 2^i), filled in the first time a conversion needs it (see decimalPower())
+        // only the first decimalPowerCount are there; once there, an entry never changes, so it can be read without the lock
+        static StringAsNumber decimalPowers[DECIMAL_POWER_LEVELS];
+        static std::atomic<int> decimalPowerCount;
+        // decimalReciprocals[i] = reciprocal(decimalPowers[i], decimalReciprocalPrecisions[i]) (see decimalReciprocal());
+        // unlike the powers, these are replaced by more precise ones when needed, so they are only touched under the lock
+        static StringAsNumber decimalReciprocals[DECIMAL_POWER_LEVELS];
+        static int decimalReciprocalPrecisions[DECIMAL_POWER_LEVELS];
+        static std::mutex decimalMutex; // any number of threads can convert numbers at the same time, and fill the caches
+
+        Limb* limbs; // either inlineLimbs or an array on the heap
+        int size; // how many limbs are used (0 for the number 0); the most significant used limb is never 0
+        int capacity; // how many limbs there is room for
+        bool negative; // 0 is never negative
+        Limb inlineLimbs[INLINE_LIMBS]; // the "small buffer", used until the number outgrows it
+
+        bool isInline() const {
+            return this->limbs == this->inlineLimbs;
+        }
+
+        void initialize() { // an empty number using the inline buffer, for the constructors
+            this->limbs = this->inlineLimbs;
+            this->size = 0;
+            this->capacity = INLINE_LIMBS;
+            this->negative = false;
+        }
+
+        void release() { // gives back the heap array, if we have one
+            if (!this->isInline()) {
+                delete[] this->limbs;
+            }
+            this->limbs = this->inlineLimbs;
+            this->capacity = INLINE_LIMBS;
+        }
+
+        bool isNegative() const { // helper for checking if a number is negative
+            return this->negative;
+        }
+
+        bool isZero() const {
+            return this->size == 0;
+        }
+
+        void reserve(int count) { // makes room for at least "count" limbs, keeping the current ones
+            if (count <= this->capacity) {
+                return;
+            }
+            Limb* tmp = new Limb[count];
+            if (this->size > 0) {
+                memcpy(tmp, this->limbs, this->size * sizeof(Limb));
+            }
+            if (!this->isInline()) {
+                delete[] this->limbs;
+            }
+            this->limbs = tmp;
+            this->capacity = count;
+        }
+
+        void grow(int count) { // like reserve, but at least doubles the room, so numbers growing a bit at a time reallocate rarely
+            if (count > this->capacity) {
+                this->reserve(count > 2 * this->capacity ? count : 2 * this->capacity);
+            }
+        }
+
+        void extendTo(int count) { // zero limbs on top, up to "count" (doesn't change the value)
+            this->grow(count);
+            while (this->size < count) {
+                this->limbs[this->size] = 0;
+                this->size++;
+            }
+        }
+
+        void addInPlace(const StringAsNumber& rhs, bool rhsNegative) {
+            // *this += rhs (or -= rhs, if rhsNegative is the opposite of rhs' sign), reusing our own limbs
+            // (rhs may be *this itself, for "a += a")
+            if (rhs.isZero()) {
+                return;
+            }
+            int rhsSize = rhs.size;
+            if (this->negative == rhsNegative || this->isZero()) {
+                // same signs: add the absolute values and keep the sign
+                this->negative = rhsNegative;
+                this->extendTo(rhsSize); // from here, the limbs of rhs are the same (if it's *this) but they may have moved
+                Limb carry = addAbs(this->limbs, this->limbs, this->size, rhs.limbs, rhsSize);
+                if (carry) {
+                    this->grow(this->size + 1);
+                    this->limbs[this->size] = carry;
+                    this->size++;
+                }
+                return;
+            }
+            // different signs: the bigger absolute value gives the sign
+            int cmp = compareAbs(this->limbs, this->size, rhs.limbs, rhsSize);
+            if (cmp >= 0) {
+                subAbs(this->limbs, this->limbs, this->size, rhs.limbs, rhsSize);
+            }
+            else {
+                // |rhs| - |this|; subAbs goes limb by limb, so it can write over the smaller operand as it goes
+                int thisSize = this->size;
+                this->extendTo(rhsSize);
+                subAbs(this->limbs, rhs.limbs, rhsSize, this->limbs, thisSize);
+                this->negative = rhsNegative;
+            }
+            this->normalize();
+        }
+
+        void normalize() { // helper for removing leading zero limbs (same as removing leading '0's from a string)
+            while (this->size > 0 && this->limbs[this->size - 1] == 0) {
+                this->size--;
+            }
+            if (this->size == 0) { // sanity check, there is no "-0"
+                this->negative = false;
+            }
+        }
+
+        // helpers working directly on limb arrays (least significant limb first)
+
+        static int compareAbs(const Limb* lhs, int lhsSize, const Limb* rhs, int rhsSize) {
+            // compare in absolute values; just like with strings, the one with more (non-zero) limbs is bigger
+            if (lhsSize != rhsSize) {
+                return lhsSize < rhsSize ? -1 : 1;
+            }
+            // same length, so compare from the most significant limb down
+            for (int i = lhsSize - 1; i >= 0; i--) {
+                if (lhs[i] != rhs[i]) {
+                    return lhs[i] < rhs[i] ? -1 : 1;
+                }
+            }
+            return 0;
+        }
+
+        static Limb addAbs(Limb* result, const Limb* big, int bigSize, const Limb* small, int smallSize) {
+            // result = big + small (bigSize >= smallSize), writes bigSize limbs and returns the final carry
+            // school addition, but each "digit" is a whole limb; result may be the same array as big
+            Limb carry = 0;
+            int i = 0;
+            for (; i < smallSize; i++) {
+                DoubleLimb sum = (DoubleLimb)big[i] + small[i] + carry;
+                result[i] = (Limb)sum; // the low 32 bits stay here
+                carry = (Limb)(sum >> LIMB_BITS); // and the rest (0 or 1) goes to the next limb
+            }
+            for (; i < bigSize; i++) {
+                DoubleLimb sum = (DoubleLimb)big[i] + carry;
+                result[i] = (Limb)sum;
+                carry = (Limb)(sum >> LIMB_BITS);
+            }
+            return carry;
+        }
+
+        static void subAbs(Limb* result, const Limb* big, int bigSize, const Limb* small, int smallSize) {
+            // result = big - small, where |big| >= |small|; school subtraction with borrow; result may be the same array as big
+            Limb borrow = 0;
+            int i = 0;
+            for (; i < smallSize; i++) {
+                DoubleLimb difference = (DoubleLimb)big[i] - small[i] - borrow;
+                result[i] = (Limb)difference;
+                borrow = (Limb)(difference >> 63); // if it went below 0, it wrapped around and the top bit is set
+            }
+            for (; i < bigSize; i++) {
+                DoubleLimb difference = (DoubleLimb)big[i] - borrow;
+                result[i] = (Limb)difference;
+                borrow = (Limb)(difference >> 63);
+            }
+        }
+
+        static void mulSchool(Limb* result, const Limb* lhs, int lhsSize, const Limb* rhs, int rhsSize) {
+            // school multiplication on limbs: result (lhsSize + rhsSize limbs) = lhs * rhs
+            // a limb times a limb plus two more limbs always fits in 64 bits: (2^32-1)^2 + 2 * (2^32-1) = 2^64 - 1
+            memset(result, 0, (lhsSize + rhsSize) * sizeof(Limb));
+            for (int i = 0; i < lhsSize; i++) {
+                Limb carry = 0;
+                DoubleLimb lhsLimb = lhs[i];
+                for (int j = 0; j < rhsSize; j++) {
+                    DoubleLimb current = lhsLimb * rhs[j] + result[i + j] + carry;
+                    result[i + j] = (Limb)current;
+                    carry = (Limb)(current >> LIMB_BITS);
+                }
+                result[i + rhsSize] = carry;
+            }
+        }
+
+        static void addInto(Limb* target, int targetSize, const Limb* number, int numberSize) {
+            // target += number, where the sum is known to fit in targetSize limbs (the carry stops before the end)
+            Limb carry = addAbs(target, target, numberSize, number, numberSize);
+            for (int i = numberSize; carry && i < targetSize; i++) {
+                target[i]++;
+                carry = target[i] == 0; // it only carries further if the limb wrapped around to 0
+            }
+        }
+
+        static void subFrom(Limb* target, int targetSize, const Limb* number, int numberSize) {
+            // target -= number, where target >= number
+            subAbs(target, target, targetSize, number, numberSize);
+        }
+
+        static int usedLimbs(const Limb* number, int size) { // size without the leading zero limbs
+            while (size > 0 && number[size - 1] == 0) {
+                size--;
+            }
+            return size;
+        }
+
+        static void multiplyAbs(Limb* result, const Limb* lhs, int lhsSize, const Limb* rhs, int rhsSize, Limb* scratch = nullptr) {
+            // result (lhsSize + rhsSize limbs) = lhs * rhs, picking the algorithm based on the sizes
+            // result must not overlap lhs or rhs; scratch is temporary space for Karatsuba (see karatsubaScratchSize), or nullptr
+            if (lhsSize < rhsSize) { // make lhs the longer one
+                const Limb* tmp = lhs;
+                lhs = rhs;
+                rhs = tmp;
+                int tmpSize = lhsSize;
+                lhsSize = rhsSize;
+                rhsSize = tmpSize;
+            }
+            if (rhsSize < karatsubaThreshold) {
+                if (rhsSize == 0) {
+                    memset(result, 0, lhsSize * sizeof(Limb));
+                    return;
+                }
+                mulSchool(result, lhs, lhsSize, rhs, rhsSize);
+                return;
+            }
+            if (rhsSize >= nttThreshold && lhsSize + rhsSize <= NTT_MAX_LENGTH) { // the NTT doesn't mind different sizes
+                mulNtt(result, lhs, lhsSize, rhs, rhsSize);
+                return;
+            }
+            if (lhsSize >= 2 * rhsSize) {
+                // very different sizes: cut lhs into rhsSize-long pieces, multiply each one by rhs (those are balanced)
+                // and add them at their place, just like multiplying by one digit at a time, but with big "digits"
+                // (the pieces' products and the scratch space for multiplying them come from a single allocation)
+                memset(result, 0, (lhsSize + rhsSize) * sizeof(Limb));
+                Limb* partial = new Limb[2 * rhsSize + (scratch ? 0 : karatsubaScratchSize(rhsSize))];
+                if (!scratch) {
+                    scratch = partial + 2 * rhsSize;
+                }
+                for (int start = 0; start < lhsSize; start += rhsSize) {
+                    int pieceSize = lhsSize - start < rhsSize ? lhsSize - start : rhsSize;
+                    multiplyAbs(partial, lhs + start, pieceSize, rhs, rhsSize, scratch);
+                    addInto(result + start, lhsSize + rhsSize - start, partial, usedLimbs(partial, pieceSize + rhsSize));
+                }
+                delete[] partial;
+                partial = nullptr;
+                return;
+            }
+            if (rhsSize < toom3Threshold) {
+                mulKaratsuba(result, lhs, lhsSize, rhs, rhsSize, scratch);
+            }
+            else {
+                mulToom3(result, lhs, lhsSize, rhs, rhsSize);
+            }
+        }
+
+        static int karatsubaScratchSize(int size) {
+            // temporary limbs needed by mulKaratsuba for a "size"-limb operand, counting its recursive calls: each level needs
+            // 4 * half + 4 for itself, and its calls (done one after the other, on operands of at most half + 1 limbs) share what follows
+            int total = 0;
+            while (size >= 4) {
+                int half = (size + 1) / 2;
+                total += 4 * half + 4;
+                size = half + 1;
+            }
+            return total;
+        }
+
+        static void mulKaratsuba(Limb* result, const Limb* lhs, int lhsSize, const Limb* rhs, int rhsSize, Limb* scratch) {
+            // Karatsuba: split both numbers in halves, lhs = a1 * B + a0 and rhs = b1 * B + b0 (B = 2^(32 * half))
+            // lhs * rhs = a1*b1 * B^2 + (a1*b0 + a0*b1) * B + a0*b0, and the middle part can be obtained from a single product:
+            // a1*b0 + a0*b1 = (a0 + a1) * (b0 + b1) - a0*b0 - a1*b1
+            // so we do 3 multiplications of half size instead of 4, which (applied recursively) gives ~n^1.585 instead of n^2
+            // here lhsSize >= rhsSize > lhsSize / 2
+            // the temporary sums and middle product live in "scratch", allocated once at the top and shared by all the levels
+            Limb* ownScratch = nullptr;
+            if (!scratch) {
+                ownScratch = new Limb[karatsubaScratchSize(lhsSize)];
+                scratch = ownScratch;
+            }
+            int half = (lhsSize + 1) / 2;
+            int lhsHigh = lhsSize - half;
+            int rhsHigh = rhsSize - half; // can be 0, but never negative
+            Limb* lhsSum = scratch;
+            Limb* rhsSum = scratch + half + 1;
+            Limb* middle = scratch + 2 * half + 2;
+            int middleSize = 2 * half + 2;
+            Limb* rest = scratch + 4 * half + 4; // for the recursive calls
+
+            // a0*b0 goes directly in the low part of the result, and a1*b1 in the high part
+            multiplyAbs(result, lhs, half, rhs, half, rest);
+            multiplyAbs(result + 2 * half, lhs + half, lhsHigh, rhs + half, rhsHigh, rest);
+
+            lhsSum[half] = addAbs(lhsSum, lhs, half, lhs + half, lhsHigh);
+            rhsSum[half] = addAbs(rhsSum, rhs, half, rhs + half, rhsHigh);
+            multiplyAbs(middle, lhsSum, half + 1, rhsSum, half + 1, rest);
+            subFrom(middle, middleSize, result, usedLimbs(result, 2 * half));
+            subFrom(middle, middleSize, result + 2 * half, usedLimbs(result + 2 * half, lhsHigh + rhsHigh));
+            addInto(result + half, lhsSize + rhsSize - half, middle, usedLimbs(middle, middleSize));
+
+            delete[] ownScratch;
+            ownScratch = nullptr;
+        }
+
+        static StringAsNumber fromLimbs(const Limb* number, int size, int start, int count) {
+            // the (non-negative) number made of "count" limbs starting at "start" (missing limbs count as 0)
+            StringAsNumber out;
+            if (start + count > size) {
+                count = size - start;
+            }
+            if (count > 0) {
+                out.reserve(count);
+                memcpy(out.limbs, number + start, count * sizeof(Limb));
+                out.size = count;
+                out.normalize();
+            }
+            return out;
+        }
+
+        void divideExact(Limb divisor) { // divides by a small number which is known to divide this one exactly
+            divSmall(this->limbs, this->size, divisor);
+            this->normalize();
+        }
+
+        static void mulToom3(Limb* result, const Limb* lhs, int lhsSize, const Limb* rhs, int rhsSize) {
+            // Toom-3: split both numbers in 3 parts, seen as polynomials p(x) = a2 * x^2 + a1 * x + a0 and q(x) = b2 * x^2 + b1 * x + b0,
+            // with x = B = 2^(32 * part); their product r(x) = p(x) * q(x) has degree 4, so 5 values of it are enough to find it:
+            // r(0), r(1), r(-1), r(-2) and r(infinity) = a2 * b2, each being one multiplication of third size
+            // 5 multiplications of n/3 instead of 9 gives ~n^1.465; the evaluations can be negative, so they use the signed operators
+            // (the sequence of steps is the one by Bodrato, which only needs exact divisions by 2 and 3)
+            int part = (lhsSize + 2) / 3;
+            StringAsNumber a0 = fromLimbs(lhs, lhsSize, 0, part);
+            StringAsNumber a1 = fromLimbs(lhs, lhsSize, part, part);
+            StringAsNumber a2 = fromLimbs(lhs, lhsSize, 2 * part, part);
+            StringAsNumber b0 = fromLimbs(rhs, rhsSize, 0, part);
+            StringAsNumber b1 = fromLimbs(rhs, rhsSize, part, part);
+            StringAsNumber b2 = fromLimbs(rhs, rhsSize, 2 * part, part);
+
+            // evaluation: p(1) = a0 + a1 + a2, p(-1) = a0 - a1 + a2, p(-2) = a0 - 2 * a1 + 4 * a2 = 2 * (p(-1) + a2) - a0
+            StringAsNumber lhsEven = a0 + a2;
+            StringAsNumber lhsOne = lhsEven + a1;
+            StringAsNumber lhsMinusOne = lhsEven - a1;
+            StringAsNumber lhsMinusTwo = lhsMinusOne + a2;
+            lhsMinusTwo = lhsMinusTwo + lhsMinusTwo - a0;
+            StringAsNumber rhsEven = b0 + b2;
+            StringAsNumber rhsOne = rhsEven + b1;
+            StringAsNumber rhsMinusOne = rhsEven - b1;
+            StringAsNumber rhsMinusTwo = rhsMinusOne + b2;
+            rhsMinusTwo = rhsMinusTwo + rhsMinusTwo - b0;
+
+            // the 5 products (these recurse back into multiplyAbs)
+            StringAsNumber r0 = a0 * b0;
+            StringAsNumber rOne = lhsOne * rhsOne;
+            StringAsNumber rMinusOne = lhsMinusOne * rhsMinusOne;
+            StringAsNumber rMinusTwo = lhsMinusTwo * rhsMinusTwo;
+            StringAsNumber r4 = a2 * b2;
+
+            // interpolation: get back the coefficients r0..r4 of r(x)
+            StringAsNumber r3 = rMinusTwo - rOne;
+            r3.divideExact(3);
+            StringAsNumber r1 = rOne - rMinusOne;
+            r1.divideExact(2);
+            StringAsNumber r2 = rMinusOne - r0;
+            r3 = r2 - r3;
+            r3.divideExact(2);
+            r3 = r3 + r4 + r4;
+            r2 = r2 + r1 - r4;
+            r1 = r1 - r3;
+
+            // recomposition: result = r0 + r1 * B + r2 * B^2 + r3 * B^3 + r4 * B^4 (all of them are >= 0, they are coefficients of a product)
+            int resultSize = lhsSize + rhsSize;
+            memset(result, 0, resultSize * sizeof(Limb));
+            const StringAsNumber* coefficients[5] = { &r0, &r1, &r2, &r3, &r4 };
+            for (int i = 0; i < 5; i++) {
+                addInto(result + i * part, resultSize - i * part, coefficients[i]->limbs, coefficients[i]->size);
+            }
+        }
+
+        static Limb powMod(Limb base, Limb exponent, Limb mod) { // base^exponent % mod, for the small (single limb) primes of the NTT
+            DoubleLimb result = 1;
+            DoubleLimb power = base % mod;
+            while (exponent > 0) {
+                if (exponent & 1) {
+                    result = result * power % mod;
+                }
+                power = power * power % mod;
+                exponent >>= 1;
+            }
+            return (Limb)result;
+        }
+
+        template <Limb MOD>
+        static void transform(Limb* values, int length, bool inverse) {
+            // number theoretic transform: the FFT, but computed modulo a prime instead of with complex numbers, so it is exact
+            // it evaluates the polynomial values[0] + values[1] * x + ... at the "length"-th roots of unity modulo MOD
+            // (3 generates all the numbers modulo each of our primes, so 3^((MOD - 1) / length) is such a root),
+            // and the inverse transform goes back from the values to the coefficients
+            // MOD is a template parameter so that the compiler knows it and turns "% MOD" into cheap multiplications
+            for (int i = 1, j = 0; i < length; i++) { // put the values in bit-reversed order, as the iterative algorithm expects
+                int bit = length >> 1;
+                for (; j & bit; bit >>= 1) {
+                    j ^= bit;
+                }
+                j ^= bit;
+                if (i < j) {
+                    Limb tmp = values[i];
+                    values[i] = values[j];
+                    values[j] = tmp;
+                }
+            }
+            Limb* roots = new Limb[length / 2 > 0 ? length / 2 : 1];
+            for (int half = 1; half < length; half *= 2) {
+                // combine the transforms of length "half" into ones of length 2 * half
+                Limb root = powMod(3, (MOD - 1) / (2 * half), MOD);
+                if (inverse) {
+                    root = powMod(root, MOD - 2, MOD); // inverse modulo a prime, by Fermat's little theorem
+                }
+                roots[0] = 1;
+                for (int j = 1; j < half; j++) {
+                    roots[j] = (Limb)((DoubleLimb)roots[j - 1] * root % MOD);
+                }
+                for (int start = 0; start < length; start += 2 * half) {
+                    for (int j = 0; j < half; j++) {
+                        Limb even = values[start + j];
+                        Limb odd = (Limb)((DoubleLimb)values[start + j + half] * roots[j] % MOD);
+                        values[start + j] = even + odd >= MOD ? even + odd - MOD : even + odd; // both are < MOD < 2^31, so no overflow
+                        values[start + j + half] = even >= odd ? even - odd : even + MOD - odd;
+                    }
+                }
+            }
+            delete[] roots;
+            roots = nullptr;
+            if (inverse) {
+                Limb scale = powMod((Limb)length, MOD - 2, MOD); // the inverse transform also divides by the length
+                for (int i = 0; i < length; i++) {
+                    values[i] = (Limb)((DoubleLimb)values[i] * scale % MOD);
+                }
+            }
+        }
+
+        template <Limb MOD>
+        static void convolve(Limb* result, const Limb* lhs, int lhsSize, const Limb* rhs, int rhsSize, int length) {
+            // result = lhs * rhs as polynomials (no carries), with every coefficient taken modulo MOD
+            Limb* other = new Limb[length];
+            for (int i = 0; i < length; i++) {
+                result[i] = i < lhsSize ? lhs[i] % MOD : 0;
+                other[i] = i < rhsSize ? rhs[i] % MOD : 0;
+            }
+            transform<MOD>(result, length, false);
+            transform<MOD>(other, length, false);
+            for (int i = 0; i < length; i++) { // after the transform, multiplying polynomials is just multiplying their values
+                result[i] = (Limb)((DoubleLimb)result[i] * other[i] % MOD);
+            }
+            transform<MOD>(result, length, true);
+            delete[] other;
+            other = nullptr;
+        }
+
+        static void mulNtt(Limb* result, const Limb* lhs, int lhsSize, const Limb* rhs, int rhsSize) {
+            // the limbs are the coefficients of two polynomials (in x = 2^32), so their product is the product of the polynomials
+            // (a convolution), followed by propagating the carries; the NTT does the convolution in ~n log n instead of n^2
+            // a coefficient of the product can reach min(size) * (2^32 - 1)^2 < 2^86, too much for one prime, so we do the convolution
+            // modulo 3 different primes and rebuild the real value from the 3 remainders (Chinese remainder theorem) -
+            // their product is ~2^86, so every coefficient is < it as long as the transform is at most 2^23 long
+            int length = 1;
+            while (length < lhsSize + rhsSize - 1) {
+                length *= 2;
+            }
+            Limb* residues1 = new Limb[length];
+            Limb* residues2 = new Limb[length];
+            Limb* residues3 = new Limb[length];
+            convolve<NTT_PRIME1>(residues1, lhs, lhsSize, rhs, rhsSize, length);
+            convolve<NTT_PRIME2>(residues2, lhs, lhsSize, rhs, rhsSize, length);
+            convolve<NTT_PRIME3>(residues3, lhs, lhsSize, rhs, rhsSize, length);
+
+            // Garner's algorithm: value = r1 + p1 * k2 + p1 * p2 * k3, where k2 < p2 and k3 < p3 are picked so that
+            // value % p2 == r2 and value % p3 == r3
+            const DoubleLimb inverse1 = powMod(NTT_PRIME1 % NTT_PRIME2, NTT_PRIME2 - 2, NTT_PRIME2); // 1 / p1 modulo p2
+            const DoubleLimb product12 = (DoubleLimb)NTT_PRIME1 * NTT_PRIME2; // < 2^58
+            const DoubleLimb inverse12 = powMod((Limb)(product12 % NTT_PRIME3), NTT_PRIME3 - 2, NTT_PRIME3); // 1 / (p1 * p2) modulo p3
+            const DoubleLimb mask = 0xFFFFFFFFull;
+            DoubleLimb carry = 0; // what is left over for the next limbs (always < 2^57)
+            for (int i = 0; i < lhsSize + rhsSize; i++) {
+                if (i >= lhsSize + rhsSize - 1) { // the last limb is only carry
+                    result[i] = (Limb)carry;
+                    break;
+                }
+                DoubleLimb r1 = residues1[i];
+                DoubleLimb k2 = (residues2[i] + NTT_PRIME2 - r1 % NTT_PRIME2) % NTT_PRIME2 * inverse1 % NTT_PRIME2;
+                DoubleLimb low = r1 + NTT_PRIME1 * k2; // r1 + p1 * k2 < p1 * p2 < 2^58
+                DoubleLimb k3 = (residues3[i] + NTT_PRIME3 - low % NTT_PRIME3) % NTT_PRIME3 * inverse12 % NTT_PRIME3;
+                // value = low + product12 * k3 can need up to 86 bits, so the high product is split in two 32-bit halves
+                DoubleLimb highLow = (product12 & mask) * k3;
+                DoubleLimb highHigh = (product12 >> 32) * k3;
+                DoubleLimb sum = (low & mask) + (highLow & mask) + (carry & mask);
+                result[i] = (Limb)sum;
+                carry = (low >> 32) + (highLow >> 32) + highHigh + (carry >> 32) + (sum >> 32);
+            }
+            delete[] residues1;
+            residues1 = nullptr;
+            delete[] residues2;
+            residues2 = nullptr;
+            delete[] residues3;
+            residues3 = nullptr;
+        }
+
+        static Limb mulAddSmall(Limb* number, int size, Limb factor, Limb add) { // number = number * factor + add, returns the carry out
+            Limb carry = add;
+            for (int i = 0; i < size; i++) {
+                DoubleLimb current = (DoubleLimb)number[i] * factor + carry;
+                number[i] = (Limb)current;
+                carry = (Limb)(current >> LIMB_BITS);
+            }
+            return carry;
+        }
+
+        static Limb divSmall(Limb* number, int size, Limb divisor) { // number = number / divisor, returns the remainder
+            // school long division by a single "digit", from the most significant limb down
+            DoubleLimb remainder = 0;
+            for (int i = size - 1; i >= 0; i--) {
+                DoubleLimb current = (remainder << LIMB_BITS) | number[i];
+                number[i] = (Limb)(current / divisor);
+                remainder = current % divisor;
+            }
+            return (Limb)remainder;
+        }
+
+        static const StringAsNumber& decimalPower(int level) { // 10^(9 * 2^level), each one computed only once
+            // every power is the square of the previous one, and they are kept for all the later conversions
+            if (level < decimalPowerCount.load(std::memory_order_acquire)) { // the usual case: already there, no need to lock
+                return decimalPowers[level];
+            }
+            std::lock_guard<std::mutex> lock(decimalMutex);
+            int count = decimalPowerCount.load(std::memory_order_relaxed); // another thread may have added some meanwhile
+            if (count == 0) {
+                decimalPowers[0] = fromInteger(DECIMAL_CHUNK);
+                count = 1;
+            }
+            while (count <= level) {
+                decimalPowers[count] = decimalPowers[count - 1] * decimalPowers[count - 1];
+                count++;
+            }
+            decimalPowerCount.store(count, std::memory_order_release); // only now can other threads read the new ones
+            return decimalPowers[level];
+        }
+
+        static StringAsNumber decimalReciprocal(int level, int precision) { // reciprocal(decimalPower(level), precision)
+            // the same power divides many pieces of the number (2^k of them k levels down), so its reciprocal is computed once
+            // and kept; a more precise one is only computed if a bigger number needs it, and cut down to the precision asked for
+            // (dropping limbs of ~ B^(p + size) / power gives ~ B^(p' + size) / power, still off by just a few units)
+            const StringAsNumber& power = decimalPower(level);
+            std::lock_guard<std::mutex> lock(decimalMutex);
+            if (decimalReciprocalPrecisions[level] < precision) {
+                decimalReciprocals[level] = reciprocal(power, precision);
+                decimalReciprocalPrecisions[level] = precision;
+            }
+            return shiftLimbs(decimalReciprocals[level], precision - decimalReciprocalPrecisions[level]);
+        }
+
+        static int decimalSplitLevel(int digits) {
+            // the biggest level with 10^(9 * 2^level) having at most 2/3 of "digits" digits; the powers double at every level,
+            // so this one has between 1/3 and 2/3 of them, and splitting there gives two parts of similar sizes
+            int level = 0;
+            while (level + 1 < DECIMAL_POWER_LEVELS && (DECIMAL_CHUNK_DIGITS << (level + 1)) <= digits / 3 * 2) {
+                level++;
+            }
+            return level;
+        }
+
+        static StringAsNumber parseDigits(const char* digits, int count) { // the (already validated) digits as a non-negative number
+            // going through the digits one chunk at a time costs a pass over the whole number for every chunk, i.e. time ~ digits^2
+            // so long strings are split instead: number = high part * 10^(digits of the low part) + low part,
+            // with both parts converted the same way and the power of 10 taken from the cache; this way all the work
+            // goes into a few big multiplications, which are much faster than digits^2
+            if (count > DECIMAL_SPLIT_LIMBS * DECIMAL_CHUNK_DIGITS) {
+                int level = decimalSplitLevel(count);
+                int lowCount = DECIMAL_CHUNK_DIGITS << level;
+                StringAsNumber out = parseDigits(digits, count - lowCount);
+                out *= decimalPower(level);
+                out += parseDigits(digits + count - lowCount, lowCount);
+                return out;
+            }
+
+            // every 9 decimal digits fit in a limb, so this is always enough room
+            StringAsNumber out;
+            out.reserve(count / DECIMAL_CHUNK_DIGITS + 1);
+            // take the digits 9 at a time: number = number * 10^9 + next 9 digits
+            // the first chunk takes what is left over, so all the others have exactly 9 digits
+            int position = 0;
+            int chunkLength = count % DECIMAL_CHUNK_DIGITS;
+            if (chunkLength == 0) {
+                chunkLength = DECIMAL_CHUNK_DIGITS;
+            }
+            while (position < count) {
+                Limb chunk = 0;
+                Limb scale = 1;
+                for (int i = 0; i < chunkLength; i++) {
+                    chunk = chunk * 10 + (digits[position + i] - '0'); // convert to int
+                    scale *= 10;
+                }
+                Limb carry = mulAddSmall(out.limbs, out.size, scale, chunk);
+                if (carry) {
+                    out.limbs[out.size] = carry;
+                    out.size++;
+                }
+                position += chunkLength;
+                chunkLength = DECIMAL_CHUNK_DIGITS;
+            }
+            out.normalize();
+            return out;
+        }
+
+        static void writeChunks(const Limb* number, int size, int width, std::string& out) {
+            // appends the digits of a (small, non-negative) number, padded with '0's in front to "width" digits
+            // repeatedly divide by 10^9 - each remainder gives the next 9 decimal digits, from the least significant ones up
+            Limb tmpSmall[DECIMAL_SPLIT_LIMBS];
+            Limb* tmp = size <= DECIMAL_SPLIT_LIMBS ? tmpSmall : new Limb[size];
+            memcpy(tmp, number, size * sizeof(Limb));
+            int tmpSize = usedLimbs(tmp, size);
+            int chunkCount = 0;
+            Limb chunkSmall[2 * DECIMAL_SPLIT_LIMBS];
+            Limb* chunks = size <= DECIMAL_SPLIT_LIMBS ? chunkSmall : new Limb[size * 2]; // 2^32 < 10^18, so every limb gives at most 2 chunks
+            while (tmpSize > 0) {
+                chunks[chunkCount] = divSmall(tmp, tmpSize, DECIMAL_CHUNK);
+                chunkCount++;
+                while (tmpSize > 0 && tmp[tmpSize - 1] == 0) {
+                    tmpSize--;
+                }
+            }
+
+            // the most significant chunk has no leading '0's (unless the padding asks for them)
+            std::string first = chunkCount > 0 ? std::to_string(chunks[chunkCount - 1]) : "";
+            int digits = chunkCount > 0 ? (int)first.size() + (chunkCount - 1) * DECIMAL_CHUNK_DIGITS : 0;
+            if (width > digits) {
+                out.append(width - digits, '0');
+            }
+            out += first;
+            for (int i = chunkCount - 2; i >= 0; i--) {
+                // the other ones are padded to exactly 9 digits
+                char buffer[DECIMAL_CHUNK_DIGITS + 1];
+                Limb chunk = chunks[i];
+                for (int j = DECIMAL_CHUNK_DIGITS - 1; j >= 0; j--) {
+                    buffer[j] = (char)('0' + chunk % 10);
+                    chunk /= 10;
+                }
+                out.append(buffer, DECIMAL_CHUNK_DIGITS);
+            }
+            if (tmp != tmpSmall) {
+                delete[] tmp;
+            }
+            tmp = nullptr;
+            if (chunks != chunkSmall) {
+                delete[] chunks;
+            }
+            chunks = nullptr;
+        }
+
+        static void writeDigits(const StringAsNumber& number, int width, std::string& out) {
+            // appends the digits of a non-negative number, padded to "width" digits (0 = no padding)
+            // the reverse of parseDigits(): number = high part * 10^k + low part, with 10^k close to the square root of the number,
+            // so both parts have (roughly) half of the digits; the low part is padded to exactly k digits, since its leading '0's matter
+            if (number.size <= DECIMAL_SPLIT_LIMBS) {
+                writeChunks(number.limbs, number.size, width, out);
+                return;
+            }
+            int level = decimalSplitLevel(digitsInLimbs(number.size));
+            StringAsNumber high;
+            StringAsNumber low;
+            const StringAsNumber& power = decimalPower(level);
+            if (power.size >= DECIMAL_RECIPROCAL_LIMBS) {
+                // two multiplications with a reciprocal we already have beat long division long before Newton's method
+                // (which has to compute the reciprocal first) does, so this doesn't wait for newtonThreshold
+                int precision = number.size - power.size + 4; // enough for the quotient, see divideNewton()
+                divideByReciprocal(number, power, decimalReciprocal(level, precision), precision, high, low);
+            }
+            else {
+                number.divmod(power, high, low);
+            }
+            int lowWidth = DECIMAL_CHUNK_DIGITS << level;
+            writeDigits(high, width > lowWidth ? width - lowWidth : 0, out);
+            writeDigits(low, lowWidth, out);
+        }
+
+        static int digitsInLimbs(int size) { // (about) how many decimal digits a number with "size" limbs has: 32 * log10(2) ~ 9.63 per limb
+            return (int)(size * 9.63);
+        }
+
+        bool parse(const char* text) { // reads a decimal string into the limbs; returns false if it's not a valid number
+            if (!text || text[0] == '\0') { // if not a valid src array
+                return false;
+            }
+            int length = strlen(text);
+            int start = 0;
+            // check for leading '-'
+            if (text[0] == '-') {
+                start = 1;
+                // string must not be only "-"
+                if (length == 1) {
+                    return false;
+                }
+            }
+            for (int i = start; i < length; i++) {
+                if (text[i] < '0' || text[i] > '9') { // validate that we only get numbers as strings
+                    // in the ascii table, we get the digits one after the other, starting at number 48 (0x30), which is '0'
+                    // up to 57 (0x39), which is '9'
+                    // therefore, anything smaller than 0x30 or bigger than 0x39 would not be a digit
+                    return false;
+                }
+            }
+
+            *this = parseDigits(text + start, length - start);
+            this->negative = start == 1;
+            this->normalize();
+            return true;
+        }
+
+        static StringAsNumber addSigned(const StringAsNumber& lhs, const StringAsNumber& rhs, bool rhsNegative) {
+            // lhs + rhs, with rhs taken as negative if rhsNegative (so subtraction is addition with the sign of rhs flipped)
+            StringAsNumber out;
+            if (lhs.negative == rhsNegative) {
+                // same signs: add the absolute values and keep the sign, i.e. -a + (-b) = -(a + b)
+                const StringAsNumber& big = lhs.size >= rhs.size ? lhs : rhs;
+                const StringAsNumber& small = lhs.size >= rhs.size ? rhs : lhs;
+                out.reserve(big.size);
+                Limb carry = addAbs(out.limbs, big.limbs, big.size, small.limbs, small.size);
+                out.size = big.size;
+                if (carry) { // only make room for one more limb when there really is a carry
+                    out.reserve(big.size + 1);
+                    out.limbs[big.size] = carry;
+                    out.size++;
+                }
+                out.negative = rhsNegative;
+            }
+            else {
+                // different signs: subtract the smaller absolute value from the bigger one, the bigger one gives the sign
+                // i.e. -a + b = b - a, a + (-b) = a - b
+                int cmp = compareAbs(lhs.limbs, lhs.size, rhs.limbs, rhs.size);
+                if (cmp == 0) { // a - a = 0
+                    return out;
+                }
+                const StringAsNumber& big = cmp > 0 ? lhs : rhs;
+                const StringAsNumber& small = cmp > 0 ? rhs : lhs;
+                out.reserve(big.size);
+                subAbs(out.limbs, big.limbs, big.size, small.limbs, small.size);
+                out.size = big.size;
+                out.negative = cmp > 0 ? lhs.negative : rhsNegative;
+            }
+            out.normalize();
+            return out;
+        }
+
+        static int leadingZeros(Limb limb) { // how many 0 bits are in front of the first 1 (limb must not be 0)
+            int count = 0;
+            for (int bits = LIMB_BITS / 2; bits > 0; bits /= 2) { // binary search for the highest 1 bit
+                if (limb >> (LIMB_BITS - bits) == 0) {
+                    count += bits;
+                    limb <<= bits;
+                }
+            }
+            return count;
+        }
+
+        static void divideKnuth(const Limb* dividend, int dividendSize, const Limb* divisor, int divisorSize, Limb* quotient, Limb* remainder) {
+            // long division, the school way, with limbs as digits (Knuth's Algorithm D): for each position, guess the next
+            // quotient "digit" from the top two limbs of what's left and the top limb of the divisor, then subtract guess * divisor
+            // quotient gets dividendSize - divisorSize + 1 limbs and remainder gets divisorSize limbs; divisorSize >= 2
+            // the guess is never too small and at most 2 too big if the divisor's top limb has its highest bit set,
+            // so both numbers are first shifted left until it does (which doesn't change the quotient)
+            int shift = leadingZeros(divisor[divisorSize - 1]);
+            // both temporary arrays come from the stack when they are small, and from the heap otherwise
+            Limb smallScratch[SMALL_SCRATCH];
+            int scratchSize = divisorSize + dividendSize + 1;
+            Limb* scratch = scratchSize <= SMALL_SCRATCH ? smallScratch : new Limb[scratchSize];
+            Limb* divisorShifted = scratch;
+            Limb* current = scratch + divisorSize; // what's left of the dividend
+            for (int i = divisorSize - 1; i > 0; i--) {
+                divisorShifted[i] = (divisor[i] << shift) | (shift ? divisor[i - 1] >> (LIMB_BITS - shift) : 0);
+            }
+            divisorShifted[0] = divisor[0] << shift;
+            current[dividendSize] = shift ? dividend[dividendSize - 1] >> (LIMB_BITS - shift) : 0;
+            for (int i = dividendSize - 1; i > 0; i--) {
+                current[i] = (dividend[i] << shift) | (shift ? dividend[i - 1] >> (LIMB_BITS - shift) : 0);
+            }
+            current[0] = dividend[0] << shift;
+
+            const DoubleLimb base = (DoubleLimb)1 << LIMB_BITS;
+            Limb top = divisorShifted[divisorSize - 1];
+            Limb second = divisorShifted[divisorSize - 2];
+            for (int j = dividendSize - divisorSize; j >= 0; j--) {
+                // guess the quotient digit from the top 2 limbs, then fix it using the next limb (so it's at most 1 too big)
+                DoubleLimb numerator = ((DoubleLimb)current[j + divisorSize] << LIMB_BITS) | current[j + divisorSize - 1];
+                DoubleLimb guess = numerator / top;
+                DoubleLimb rest = numerator % top;
+                while (guess >= base || guess * second > ((rest << LIMB_BITS) | current[j + divisorSize - 2])) {
+                    guess--;
+                    rest += top;
+                    if (rest >= base) {
+                        break;
+                    }
+                }
+
+                // current -= guess * divisor (shifted to position j)
+                long long borrow = 0;
+                long long difference = 0;
+                for (int i = 0; i < divisorSize; i++) {
+                    DoubleLimb product = guess * divisorShifted[i];
+                    difference = (long long)current[i + j] - borrow - (long long)(product & 0xFFFFFFFFull);
+                    current[i + j] = (Limb)difference;
+                    borrow = (long long)(product >> LIMB_BITS) - (difference >> LIMB_BITS);
+                }
+                difference = (long long)current[j + divisorSize] - borrow;
+                current[j + divisorSize] = (Limb)difference;
+
+                quotient[j] = (Limb)guess;
+                if (difference < 0) { // the guess was 1 too big, so add one divisor back
+                    quotient[j]--;
+                    DoubleLimb carry = 0;
+                    for (int i = 0; i < divisorSize; i++) {
+                        DoubleLimb sum = (DoubleLimb)current[i + j] + divisorShifted[i] + carry;
+                        current[i + j] = (Limb)sum;
+                        carry = sum >> LIMB_BITS;
+                    }
+                    current[j + divisorSize] += (Limb)carry;
+                }
+            }
+
+            // what's left is the remainder, shifted back to the right
+            for (int i = 0; i < divisorSize; i++) {
+                remainder[i] = (current[i] >> shift) | (shift ? current[i + 1] << (LIMB_BITS - shift) : 0);
+            }
+            if (scratch != smallScratch) {
+                delete[] scratch;
+            }
+            scratch = divisorShifted = current = nullptr;
+        }
+
+        static void divideLimbs(const StringAsNumber& dividend, const StringAsNumber& divisor, StringAsNumber& quotient, StringAsNumber& remainder) {
+            // |dividend| / |divisor| with long division; the results are non-negative, and must not be dividend or divisor
+            if (compareAbs(dividend.limbs, dividend.size, divisor.limbs, divisor.size) < 0) { // |a| < |b| => a / b = 0
+                quotient.size = 0;
+                remainder = dividend;
+            }
+            else if (divisor.size == 1) { // dividing by a single limb is a simple school division
+                quotient = dividend;
+                Limb rest = divSmall(quotient.limbs, quotient.size, divisor.limbs[0]);
+                remainder.size = 0;
+                remainder.reserve(1);
+                remainder.limbs[0] = rest;
+                remainder.size = 1;
+            }
+            else {
+                quotient.size = 0;
+                quotient.reserve(dividend.size - divisor.size + 1);
+                remainder.size = 0;
+                remainder.reserve(divisor.size);
+                divideKnuth(dividend.limbs, dividend.size, divisor.limbs, divisor.size, quotient.limbs, remainder.limbs);
+                quotient.size = dividend.size - divisor.size + 1;
+                remainder.size = divisor.size;
+            }
+            quotient.negative = false;
+            remainder.negative = false;
+            quotient.normalize();
+            remainder.normalize();
+        }
+
+        static StringAsNumber shiftLimbs(const StringAsNumber& number, int count) {
+            // number * B^count for count > 0, or number / B^count (dropping the lowest limbs) for count < 0, where B = 2^32
+            StringAsNumber out;
+            int newSize = number.size + count;
+            if (number.isZero() || newSize <= 0) {
+                return out;
+            }
+            out.reserve(newSize);
+            if (count >= 0) {
+                memset(out.limbs, 0, count * sizeof(Limb));
+                memcpy(out.limbs + count, number.limbs, number.size * sizeof(Limb));
+            }
+            else {
+                memcpy(out.limbs, number.limbs - count, newSize * sizeof(Limb));
+            }
+            out.size = newSize;
+            out.negative = number.negative;
+            out.normalize();
+            return out;
+        }
+
+        static StringAsNumber reciprocal(const StringAsNumber& divisor, int precision) {
+            // ~ B^(2 * precision) / top, where top is the divisor cut (or padded with zero limbs) to its "precision" most significant limbs
+            // (so ~ B^(precision + divisor.size) / divisor), off by a few units at most
+            // Newton's method for 1 / d: x = x + x * (1 - d * x), which doubles the number of correct digits at each step;
+            // so we get a reciprocal with half the precision (recursively), and do one step at full precision,
+            // which costs about as much as a couple of multiplications of that size
+            // the half precision one gets 2 extra (guard) limbs, otherwise the limb or so lost to rounding at each level
+            // would double at every step
+            StringAsNumber top = shiftLimbs(divisor, precision - divisor.size);
+            StringAsNumber one = shiftLimbs(fromInteger(1), 2 * precision); // "1" is B^(2 * precision) at this precision
+            if (precision <= RECIPROCAL_BASE_CASE) {
+                StringAsNumber quotient;
+                StringAsNumber remainder;
+                divideLimbs(one, top, quotient, remainder);
+                return quotient;
+            }
+            int half = precision / 2 + 2;
+            StringAsNumber x = shiftLimbs(reciprocal(divisor, half), precision - half);
+            StringAsNumber error = one - top * x; // can be negative, if x is a bit too big
+            return x + shiftLimbs(x * error, -2 * precision);
+        }
+
+        static void divideNewton(const StringAsNumber& dividend, const StringAsNumber& divisor, StringAsNumber& quotient, StringAsNumber& remainder) {
+            // |dividend| / |divisor| as |dividend| * (1 / |divisor|), with the reciprocal from Newton's method, so division costs
+            // about as much as a few multiplications (which are fast for big numbers) instead of the n^2 of long division
+            StringAsNumber a = dividend;
+            StringAsNumber b = divisor;
+            a.negative = false;
+            b.negative = false;
+            // the quotient has at most a.size - b.size + 1 limbs, and the reciprocal is good to all but its last 2 limbs,
+            // so 3 more limbs keep the quotient within a couple of units
+            int precision = a.size - b.size + 4;
+            StringAsNumber inverse = reciprocal(b, precision); // ~ B^(precision + b.size) / b
+            divideByReciprocal(a, b, inverse, precision, quotient, remainder);
+        }
+
+        static void divideByReciprocal(const StringAsNumber& a, const StringAsNumber& b, const StringAsNumber& inverse, int precision,
+            StringAsNumber& quotient, StringAsNumber& remainder) {
+            // a / b for non-negative a and b, given inverse = reciprocal(b, precision), where precision >= a.size - b.size + 4
+            // (split out of divideNewton(), so that a reciprocal can be reused for many divisions by the same number)
+            // the lowest b.size - 1 limbs of a change a * inverse / B^(precision + b.size) by less than B^(b.size - 1) / b <= 1,
+            // so they are left out of the multiplication: that makes it about precision x precision limbs instead of a.size x precision
+            int dropped = b.size - 1;
+            quotient = shiftLimbs(shiftLimbs(a, -dropped) * inverse, -(precision + b.size - dropped));
+            remainder = a - quotient * b;
+            // the reciprocal is off by a few units, so the quotient can be off by a couple; fix it using the remainder
+            while (remainder.negative) {
+                quotient -= fromInteger(1);
+                remainder += b;
+            }
+            while (compareAbs(remainder.limbs, remainder.size, b.limbs, b.size) >= 0) {
+                quotient += fromInteger(1);
+                remainder -= b;
+            }
+        }
+
+    public:
+        StringAsNumber() { // default constructor, the number 0 (no limbs)
+            this->initialize();
+        }
+
+        StringAsNumber(const char* number) { // parametrized constructor
+            this->initialize();
+            if (!this->parse(number)) {
+                std::cout << "Invalid number!" << std::endl;
+                // default init in this case
+                this->size = 0;
+                this->negative = false;
+            }
+        }
+
+        StringAsNumber(const StringAsNumber& other) { // copy constructor
+            this->initialize();
+            this->reserve(other.size); // only allocates if it doesn't fit in the inline buffer
+            if (other.size > 0) {
+                memcpy(this->limbs, other.limbs, other.size * sizeof(Limb));
+            }
+            this->size = other.size;
+            this->negative = other.negative;
+        }
+
+        StringAsNumber(StringAsNumber&& other) noexcept { // move constructor - takes over the heap array of "other" instead of copying it
+            this->initialize();
+            *this = std::move(other);
+        }
+
+        static StringAsNumber fromInteger(long long value) { // a number from a regular integer, without going through a string
+            StringAsNumber out;
+            // take the absolute value as unsigned, so that even the smallest long long (which has no positive counterpart) works
+            unsigned long long magnitude = value < 0 ? 0ull - (unsigned long long)value : (unsigned long long)value;
+            out.limbs[0] = (Limb)magnitude;
+            out.limbs[1] = (Limb)(magnitude >> LIMB_BITS);
+            out.size = 2;
+            out.negative = value < 0;
+            out.normalize();
+            return out;
+        }
+
+        ~StringAsNumber() { // destructor
+            this->release();
+            this->limbs = nullptr;
+        }
+
+        StringAsNumber& operator=(const StringAsNumber& other) { // copy-assignment operator - marks the rule of three complete
+            // as we have all three (copy constructor, destructor and copy-assignment operator)
+            if (this != &other) { // guard against self-assignment
+                this->size = 0; // nothing to keep when growing
+                this->reserve(other.size); // reuses our own array if it's big enough
+                if (other.size > 0) {
+                    memcpy(this->limbs, other.limbs, other.size * sizeof(Limb));
+                }
+                this->size = other.size;
+                this->negative = other.negative;
+            }
+            return *this;
+        }
+
+        StringAsNumber& operator=(StringAsNumber&& other) noexcept { // move-assignment operator (rule of five, with the move constructor)
+            // "other" is a temporary (or std::move'd) and about to go away, so we can steal its heap array instead of copying
+            if (this != &other) {
+                if (other.isInline()) { // an inline number has nothing to steal, so just copy its (at most 4) limbs
+                    this->size = 0;
+                    this->reserve(other.size);
+                    memcpy(this->limbs, other.limbs, other.size * sizeof(Limb));
+                }
+                else {
+                    this->release();
+                    this->limbs = other.limbs;
+                    this->capacity = other.capacity;
+                    other.limbs = other.inlineLimbs; // leave "other" as a valid 0
+                    other.capacity = INLINE_LIMBS;
+                }
+                this->size = other.size;
+                this->negative = other.negative;
+                other.size = 0;
+                other.negative = false;
+            }
+            return *this;
+        }
+
+        bool operator==(const StringAsNumber& rhs) const {
+            return this->negative == rhs.negative && compareAbs(this->limbs, this->size, rhs.limbs, rhs.size) == 0;
+        }
+
+        bool operator!=(const StringAsNumber& rhs) const {
+            return !(*this == rhs);
+        }
+
+        bool operator<(const StringAsNumber& rhs) const {
+            bool leftNeg = this->isNegative();
+            bool rightNeg = rhs.isNegative();
+
+            // simple checks for sign mismatches
+            if (leftNeg && !rightNeg) {
+                return true;
+            }
+            if (!leftNeg && rightNeg) {
+                return false;
+            }
+
+            int cmp = compareAbs(this->limbs, this->size, rhs.limbs, rhs.size);
+            // if both are negative
+            //      if cmp > 0 <=> leftHandSide is bigger than the rightHandSide
+            //          when adding back the negatives, the signs will flip, and therefore leftHandSide will be smaller than rightHandSide
+            //          which makes the operator return true, since we have "operator<"
+            // if both are positive
+            //      if cmp < 0 <=> leftHandSide is smaller than rightHandSide, which makes this operator return true
+            return leftNeg && rightNeg ? cmp > 0 : cmp < 0;
+        }
+
+        bool operator<=(const StringAsNumber& rhs) const {
+            return *this < rhs || *this == rhs;
+        }
+
+        bool operator>(const StringAsNumber& rhs) const {
+            return !(*this <= rhs);
+        }
+
+        bool operator>=(const StringAsNumber& rhs) const {
+            return !(*this < rhs);
+        }
+
+        StringAsNumber operator+(const StringAsNumber& rhs) const {
+            return addSigned(*this, rhs, rhs.negative);
+        }
+
+        StringAsNumber operator-(const StringAsNumber& rhs) const {
+            // a - b = a + (-b)
+            return addSigned(*this, rhs, !rhs.negative && !rhs.isZero());
+        }
+
+        StringAsNumber operator*(const StringAsNumber& rhs) const {
+            // check for multiplication with zero
+            StringAsNumber out;
+            if (this->isZero() || rhs.isZero()) {
+                return out;
+            }
+            out.multiplyFrom(*this, rhs);
+            return out;
+        }
+
+        void multiplyFrom(const StringAsNumber& lhs, const StringAsNumber& rhs) {
+            // *this = lhs * rhs, where lhs or rhs may be *this; the product goes in a separate array (it can't be done in place),
+            // which is on the stack for small numbers, so that products which fit in the inline buffer don't allocate
+            if (lhs.isZero() || rhs.isZero()) {
+                this->size = 0;
+                this->negative = false;
+                return;
+            }
+            // result can have at most lhsSize + rhsSize limbs (just like with decimal digits)
+            int productSize = lhs.size + rhs.size;
+            bool negativeProduct = lhs.negative != rhs.negative; // check for sign mismatches
+            Limb smallProduct[SMALL_SCRATCH];
+            if (productSize <= SMALL_SCRATCH) {
+                multiplyAbs(smallProduct, lhs.limbs, lhs.size, rhs.limbs, rhs.size);
+                productSize = usedLimbs(smallProduct, productSize);
+                this->size = 0;
+                this->reserve(productSize);
+                memcpy(this->limbs, smallProduct, productSize * sizeof(Limb));
+            }
+            else if (rhs.size == 1 && &rhs != this) {
+                // times a single limb can be done in place (a common case, for example when computing factorials)
+                if (&lhs != this) {
+                    *this = lhs;
+                }
+                Limb carry = mulAddSmall(this->limbs, this->size, rhs.limbs[0], 0);
+                if (carry) {
+                    this->grow(this->size + 1);
+                    this->limbs[this->size] = carry;
+                    this->size++;
+                }
+                productSize = this->size;
+            }
+            else {
+                Limb* product = new Limb[productSize];
+                multiplyAbs(product, lhs.limbs, lhs.size, rhs.limbs, rhs.size);
+                this->release(); // only now, since lhs or rhs could be *this
+                this->limbs = product;
+                this->capacity = productSize;
+            }
+            this->size = productSize;
+            this->negative = negativeProduct;
+            this->normalize();
+        }
+
+        void divmod(const StringAsNumber& rhs, StringAsNumber& quotient, StringAsNumber& remainder) const {
+            // integer division giving both results at once, through the references (the way to "return" 2 values)
+            // the quotient is rounded towards zero and the remainder has the sign of *this, like / and % on ints,
+            // so *this == quotient * rhs + remainder
+            if (rhs.isZero()) {
+                throw "Cannot divide by zero!"; // throw is a special statement, which invokes an error
+                // we give an error for this, since we cannot return anything in this case, and we want the program to crash
+                // in the future, we'll see how we can catch those and resume gracefully, but for now we don't do any catching
+                // and hence division by 0 will crash the program, just as it regularly does
+            }
+            // work on separate objects, since quotient or remainder may be *this or rhs
+            StringAsNumber q;
+            StringAsNumber r;
+            int quotientSize = this->size - rhs.size + 1;
+            if (rhs.size >= newtonThreshold && quotientSize >= newtonThreshold) {
+                divideNewton(*this, rhs, q, r);
+            }
+            else {
+                divideLimbs(*this, rhs, q, r);
+            }
+            // check for sign mismatch
+            q.negative = this->negative != rhs.negative && !q.isZero();
+            r.negative = this->negative && !r.isZero();
+            quotient = std::move(q);
+            remainder = std::move(r);
+        }
+
+        StringAsNumber operator/(const StringAsNumber& rhs) const {
+            StringAsNumber quotient;
+            StringAsNumber remainder;
+            this->divmod(rhs, quotient, remainder);
+            return quotient;
+        }
+
+        StringAsNumber operator%(const StringAsNumber& rhs) const {
+            StringAsNumber quotient;
+            StringAsNumber remainder;
+            this->divmod(rhs, quotient, remainder);
+            return remainder;
+        }
+
+        // the compound assignment operators work on our own limbs, instead of building a new number and copying it back
+        StringAsNumber& operator+=(const StringAsNumber& rhs) {
+            this->addInPlace(rhs, rhs.negative);
+            return *this;
+        }
+
+        StringAsNumber& operator-=(const StringAsNumber& rhs) {
+            this->addInPlace(rhs, !rhs.negative);
+            return *this;
+        }
+
+        StringAsNumber& operator*=(const StringAsNumber& rhs) {
+            this->multiplyFrom(*this, rhs);
+            return *this;
+        }
+
+        StringAsNumber& operator/=(const StringAsNumber& rhs) {
+            if (rhs.size == 1 && compareAbs(this->limbs, this->size, rhs.limbs, rhs.size) >= 0) { // single limb: divide in place
+                divSmall(this->limbs, this->size, rhs.limbs[0]);
+                this->negative = this->negative != rhs.negative;
+                this->normalize();
+                return *this;
+            }
+            *this = *this / rhs;
+            return *this;
+        }
+
+        StringAsNumber& operator%=(const StringAsNumber& rhs) {
+            *this = *this % rhs;
+            return *this;
+        }
+
+        std::string toString() const { // converts the limbs back to a decimal string
+            if (this->isZero()) {
+                return "0";
+            }
+            std::string out;
+            out.reserve(digitsInLimbs(this->size) + 2);
+            if (this->negative) {
+                out += '-';
+                StringAsNumber magnitude = *this; // writeDigits() works with non-negative numbers
+                magnitude.negative = false;
+                writeDigits(magnitude, 0, out);
+            }
+            else {
+                writeDigits(*this, 0, out);
+            }
+            return out;
+        }
+
+        void printNumber() const { // small public helper for printing the number
+            std::cout << this->toString() << std::endl;
+        }
+
+        int getLimbCount() const {
+            return this->size;
+        }
+
+        int bitLength() const { // how many bits the absolute value has (0 for 0)
+            if (this->isZero()) {
+                return 0;
+            }
+            return this->size * LIMB_BITS - leadingZeros(this->limbs[this->size - 1]);
+        }
+
+        bool testBit(int bit) const { // bit number "bit" of the absolute value (bit 0 is the lowest one)
+            if (bit < 0 || bit >= this->size * LIMB_BITS) {
+                return false;
+            }
+            return (this->limbs[bit / LIMB_BITS] >> (bit % LIMB_BITS)) & 1;
+        }
+
+        // base^exponent % modulus, computed without ever building base^exponent (defined after the classes it uses)
+        // the result is between 0 and |modulus| - 1; odd moduli use Montgomery multiplication, even ones Barrett reduction
+        static StringAsNumber powmod(const StringAsNumber& base, const StringAsNumber& exponent, const StringAsNumber& modulus);
+
+        static const int DISABLED = 1 << 30; // a threshold which is never reached
+
+        static int getKaratsubaThreshold() {
+            return karatsubaThreshold;
+        }
+
+        static int getToom3Threshold() {
+            return toom3Threshold;
+        }
+
+        static int getNttThreshold() {
+            return nttThreshold;
+        }
+
+        static void setMultiplyThresholds(int karatsuba, int toom3, int ntt) { // in limbs; DISABLED turns that algorithm off
+            if (karatsuba < 4) { // below this, Karatsuba would recurse on pieces that are too small to split
+                std::cout << "Karatsuba threshold too small, using 4!" << std::endl;
+                karatsuba = 4;
+            }
+            if (toom3 < 9) { // Toom-3 needs at least 3 limbs in each of its parts
+                std::cout << "Toom-3 threshold too small, using 9!" << std::endl;
+                toom3 = 9;
+            }
+            if (ntt < 1) {
+                std::cout << "NTT threshold too small, using 1!" << std::endl;
+                ntt = 1;
+            }
+            karatsubaThreshold = karatsuba;
+            toom3Threshold = toom3;
+            nttThreshold = ntt;
+        }
+
+        static int getNewtonThreshold() {
+            return newtonThreshold;
+        }
+
+        static void setNewtonThreshold(int threshold) { // in limbs; DISABLED always uses long division
+            if (threshold < 2) { // the reciprocal needs a divisor of at least 2 limbs
+                std::cout << "Newton threshold too small, using 2!" << std::endl;
+                threshold = 2;
+            }
+            newtonThreshold = threshold;
+        }
+};
+
+// defaults picked by tuneMultiplication() on an x64 machine; static data members are defined outside of the class
+int StringAsNumber::karatsubaThreshold = KARATSUBA_DEFAULT;
+int StringAsNumber::toom3Threshold = TOOM3_DEFAULT;
+int StringAsNumber::nttThreshold = NTT_DEFAULT;
+int StringAsNumber::newtonThreshold = NEWTON_DEFAULT;
+StringAsNumber StringAsNumber::decimalPowers[StringAsNumber::DECIMAL_POWER_LEVELS];
+std::atomic<int> StringAsNumber::decimalPowerCount(0);
+StringAsNumber StringAsNumber::decimalReciprocals[StringAsNumber::DECIMAL_POWER_LEVELS];
+int StringAsNumber::decimalReciprocalPrecisions[StringAsNumber::DECIMAL_POWER_LEVELS] = {};
+std::mutex StringAsNumber::decimalMutex;
+
+int exponentWindowBits(int bits) {
+    // how many exponent bits the sliding window exponentiation handles at once: a window of k bits needs 2^(k-1) powers
+    // computed up front, and saves multiplications on every window, so longer exponents use wider windows
+    // (the same limits as the ones used by OpenSSL)
+    if (bits > 671) {
+        return 6;
+    }
+    if (bits > 239) {
+        return 5;
+    }
+    if (bits > 79) {
+        return 4;
+    }
+    if (bits > 23) {
+        return 3;
+    }
+    return 1;
+}
+
+class MontgomeryContext { // precomputed constants for multiplying (and raising to powers) modulo the same odd number many times
+    // Montgomery's idea: instead of x, work with x * R mod m, where R = 2^(32 * size) is just above the modulus
+    // the product of two such numbers, divided by R, is again in that form - and dividing by R modulo m needs no division:
+    // adding the right multiple of m (picked one limb at a time, with -1/m mod 2^32) makes the lowest limbs 0,
+    // and then dividing by R is just dropping them; so a modular multiplication costs about 2 regular ones, with no division
+    // numbers are converted into this form once at the start and back once at the end of an exponentiation
+    private:
+        typedef unsigned int Limb;
+        typedef unsigned long long DoubleLimb;
+
+        StringAsNumber modulus;
+        int size; // limbs of the modulus
+        Limb inverse; // -1 / modulus modulo 2^32
+        StringAsNumber rSquared; // R^2 mod modulus, used to convert numbers into Montgomery form
+        bool valid;
+
+        void multiply(Limb* result, const Limb* lhs, const Limb* rhs, Limb* scratch) const {
+            // result = lhs * rhs / R mod m, the "coarsely integrated operand scanning" (CIOS) way: one limb of rhs at a time,
+            // multiply and add, then immediately add the multiple of m that zeroes the lowest limb and shift it out
+            // lhs, rhs < m have "size" limbs each, scratch has size + 2; result may be lhs or rhs
+            const Limb* mod = this->modulus.limbs;
+            Limb* t = scratch;
+            memset(t, 0, (this->size + 2) * sizeof(Limb));
+            for (int i = 0; i < this->size; i++) {
+                // t += lhs * rhs[i]
+                DoubleLimb carry = 0;
+                for (int j = 0; j < this->size; j++) {
+                    DoubleLimb current = (DoubleLimb)lhs[j] * rhs[i] + t[j] + carry;
+                    t[j] = (Limb)current;
+                    carry = current >> 32;
+                }
+                DoubleLimb top = (DoubleLimb)t[this->size] + carry;
+                t[this->size] = (Limb)top;
+                t[this->size + 1] = (Limb)(top >> 32);
+
+                // t = (t + factor * m) / 2^32, where factor makes the lowest limb 0
+                Limb factor = t[0] * this->inverse;
+                DoubleLimb current = (DoubleLimb)factor * mod[0] + t[0];
+                carry = current >> 32;
+                for (int j = 1; j < this->size; j++) {
+                    current = (DoubleLimb)factor * mod[j] + t[j] + carry;
+                    t[j - 1] = (Limb)current;
+                    carry = current >> 32;
+                }
+                top = (DoubleLimb)t[this->size] + carry;
+                t[this->size - 1] = (Limb)top;
+                t[this->size] = t[this->size + 1] + (Limb)(top >> 32);
+            }
+            // t < 2m here, so at most one subtraction brings it below m
+            if (t[this->size] || StringAsNumber::compareAbs(t, this->size, mod, this->size) >= 0) {
+                StringAsNumber::subAbs(t, t, this->size + 1, mod, this->size);
+            }
+            memcpy(result, t, this->size * sizeof(Limb));
+        }
+
+        void load(const StringAsNumber& number, Limb* out, Limb* scratch) const {
+            // out = number in Montgomery form (number * R mod m), padded to "size" limbs
+            StringAsNumber reduced = number % this->modulus;
+            if (reduced.negative) { // % keeps the sign of the dividend, but here we want 0 <= reduced < m
+                reduced += this->modulus;
+            }
+            memset(out, 0, this->size * sizeof(Limb));
+            memcpy(out, reduced.limbs, reduced.size * sizeof(Limb));
+            this->multiply(out, out, this->rSquared.limbs, scratch); // x * R^2 / R = x * R
+        }
+
+        StringAsNumber store(Limb* number, Limb* scratch) const { // converts back from Montgomery form (number is overwritten)
+            Limb* one = scratch + this->size + 2;
+            memset(one, 0, this->size * sizeof(Limb));
+            one[0] = 1;
+            this->multiply(number, number, one, scratch); // x * R * 1 / R = x
+            return StringAsNumber::fromLimbs(number, this->size, 0, this->size);
+        }
+
+    public:
+        MontgomeryContext(const StringAsNumber& modulus) {
+            this->modulus = modulus;
+            this->modulus.negative = false; // the sign of the modulus doesn't matter
+            this->size = this->modulus.size;
+            this->inverse = 0;
+            this->valid = this->modulus.size > 0 && (this->modulus.limbs[0] & 1) && this->modulus != StringAsNumber::fromInteger(1);
+            if (!this->valid) {
+                std::cout << "Montgomery arithmetic needs an odd modulus bigger than 1!" << std::endl;
+                return;
+            }
+            // 1 / m mod 2^32 with Newton's method: x = x * (2 - m * x) doubles the number of correct low bits,
+            // and every odd m is its own inverse modulo 8 (3 bits), so 4 steps give 48 >= 32 bits
+            Limb low = this->modulus.limbs[0];
+            Limb x = low;
+            for (int i = 0; i < 4; i++) {
+                x *= 2 - low * x;
+            }
+            this->inverse = 0u - x;
+            this->rSquared = StringAsNumber::shiftLimbs(StringAsNumber::fromInteger(1), 2 * this->size) % this->modulus;
+            this->rSquared.extendTo(this->size); // multiply() expects all the limbs, even the leading zero ones
+        }
+
+        bool isValid() const {
+            return this->valid;
+        }
+
+        const StringAsNumber& getModulus() const {
+            return this->modulus;
+        }
+
+        StringAsNumber multiply(const StringAsNumber& lhs, const StringAsNumber& rhs) const { // lhs * rhs mod m
+            if (!this->valid) {
+                return StringAsNumber();
+            }
+            Limb* buffer = new Limb[3 * this->size + 2];
+            Limb* product = buffer;
+            Limb* scratch = buffer + this->size;
+            this->load(lhs, product, scratch); // lhs * R
+            StringAsNumber reduced = rhs % this->modulus;
+            if (reduced.negative) {
+                reduced += this->modulus;
+            }
+            reduced.extendTo(this->size);
+            this->multiply(product, product, reduced.limbs, scratch); // lhs * R * rhs / R = lhs * rhs, no conversion back needed
+            StringAsNumber out = StringAsNumber::fromLimbs(product, this->size, 0, this->size);
+            delete[] buffer;
+            buffer = nullptr;
+            return out;
+        }
+
+        StringAsNumber power(const StringAsNumber& base, const StringAsNumber& exponent) const {
+            // base^exponent mod m with a sliding window: the exponent bits are read from the top, squaring for every bit,
+            // but the 1 bits are taken in groups (windows) of up to k bits starting and ending with a 1, so that one multiplication
+            // by a precomputed odd power base^1, base^3, ..., base^(2^k - 1) handles a whole window
+            if (!this->valid) {
+                return StringAsNumber();
+            }
+            if (exponent.negative) {
+                std::cout << "Negative exponents are not supported!" << std::endl;
+                return StringAsNumber();
+            }
+            int bits = exponent.bitLength();
+            int window = exponentWindowBits(bits);
+            int powers = 1 << (window - 1);
+            // one allocation for everything: the odd powers, base^2, the result, and the scratch space for multiply() and store()
+            Limb* buffer = new Limb[(powers + 2) * this->size + 2 * this->size + 2];
+            Limb* table = buffer; // table[i] = base^(2i + 1), in Montgomery form
+            Limb* square = buffer + powers * this->size;
+            Limb* result = square + this->size;
+            Limb* scratch = result + this->size;
+            this->load(base, table, scratch);
+            this->multiply(square, table, table, scratch);
+            for (int i = 1; i < powers; i++) {
+                this->multiply(table + i * this->size, table + (i - 1) * this->size, square, scratch);
+            }
+            this->load(StringAsNumber::fromInteger(1), result, scratch);
+
+            int bit = bits - 1;
+            while (bit >= 0) {
+                if (!exponent.testBit(bit)) {
+                    this->multiply(result, result, result, scratch);
+                    bit--;
+                    continue;
+                }
+                // the longest window (at most "window" bits) from this bit down, which ends in a 1
+                int low = bit - window + 1 > 0 ? bit - window + 1 : 0;
+                while (!exponent.testBit(low)) {
+                    low++;
+                }
+                int value = 0;
+                for (int i = bit; i >= low; i--) {
+                    this->multiply(result, result, result, scratch);
+                    value = value * 2 + exponent.testBit(i);
+                }
+                this->multiply(result, result, table + (value / 2) * this->size, scratch); // value is odd: base^value = table[value / 2]
+                bit = low - 1;
+            }
+            StringAsNumber out = this->store(result, scratch);
+            delete[] buffer;
+            buffer = nullptr;
+            return out;
+        }
+};
+
+class BarrettReducer { // reduces numbers modulo a fixed modulus with two multiplications instead of a division
+    // with mu = B^(2k) / m computed once (B = 2^32, k = limbs of m), x / m ~ (x / B^(k-1)) * mu / B^(k+1), which is never too big
+    // and at most 2 too small - so x mod m = x - that * m, followed by at most 2 subtractions of m
+    // this works for any modulus (even ones too, unlike Montgomery), and pays off when reducing many numbers by the same one
+    private:
+        StringAsNumber modulus;
+        StringAsNumber mu;
+        int size;
+
+    public:
+        BarrettReducer(const StringAsNumber& modulus) {
+            if (modulus.isZero()) {
+                throw "Cannot divide by zero!";
+            }
+            this->modulus = modulus;
+            this->modulus.negative = false;
+            this->size = this->modulus.size;
+            this->mu = StringAsNumber::shiftLimbs(StringAsNumber::fromInteger(1), 2 * this->size) / this->modulus;
+        }
+
+        const StringAsNumber& getModulus() const {
+            return this->modulus;
+        }
+
+        StringAsNumber reduce(const StringAsNumber& number) const { // number mod m, between 0 and m - 1
+            if (number.negative || number.size > 2 * this->size) { // outside of what the estimate covers, so use a division
+                StringAsNumber out = number % this->modulus;
+                if (out.negative) {
+                    out += this->modulus;
+                }
+                return out;
+            }
+            StringAsNumber quotient = StringAsNumber::shiftLimbs(StringAsNumber::shiftLimbs(number, -(this->size - 1)) * this->mu, -(this->size + 1));
+            StringAsNumber out = number;
+            out -= quotient * this->modulus;
+            while (out >= this->modulus) {
+                out -= this->modulus;
+            }
+            return out;
+        }
+
+        StringAsNumber multiply(const StringAsNumber& lhs, const StringAsNumber& rhs) const { // lhs * rhs mod m, for lhs, rhs < m
+            return this->reduce(lhs * rhs);
+        }
+
+        StringAsNumber power(const StringAsNumber& base, const StringAsNumber& exponent) const {
+            // base^exponent mod m, with the same sliding window as MontgomeryContext::power
+            if (exponent.negative) {
+                std::cout << "Negative exponents are not supported!" << std::endl;
+                return StringAsNumber();
+            }
+            int bits = exponent.bitLength();
+            int window = exponentWindowBits(bits);
+            int powers = 1 << (window - 1);
+            StringAsNumber* table = new StringAsNumber[powers]; // table[i] = base^(2i + 1) mod m
+            table[0] = this->reduce(base);
+            StringAsNumber square = this->multiply(table[0], table[0]);
+            for (int i = 1; i < powers; i++) {
+                table[i] = this->multiply(table[i - 1], square);
+            }
+            StringAsNumber result = this->reduce(StringAsNumber::fromInteger(1));
+            int bit = bits - 1;
+            while (bit >= 0) {
+                if (!exponent.testBit(bit)) {
+                    result = this->multiply(result, result);
+                    bit--;
+                    continue;
+                }
+                int low = bit - window + 1 > 0 ? bit - window + 1 : 0;
+                while (!exponent.testBit(low)) {
+                    low++;
+                }
+                int value = 0;
+                for (int i = bit; i >= low; i--) {
+                    result = this->multiply(result, result);
+                    value = value * 2 + exponent.testBit(i);
+                }
+                result = this->multiply(result, table[value / 2]);
+                bit = low - 1;
+            }
+            delete[] table;
+            table = nullptr;
+            return result;
+        }
+};
+
+StringAsNumber StringAsNumber::powmod(const StringAsNumber& base, const StringAsNumber& exponent, const StringAsNumber& modulus) {
+    if (modulus.isZero()) {
+        throw "Cannot divide by zero!";
+    }
+    if (modulus.size == 1 && modulus.limbs[0] == 1) { // everything is 0 modulo 1
+        return StringAsNumber();
+    }
+    if (modulus.limbs[0] & 1) {
+        return MontgomeryContext(modulus).power(base, exponent);
+    }
+    return BarrettReducer(modulus).power(base, exponent);
+}
+
+template <int Bits>
+class FixedInt { // an unsigned integer with exactly "Bits" bits (a multiple of 64), for when the size is known in advance
+    // it works like unsigned int, just wider: everything is modulo 2^Bits, so overflows wrap around (and -1 is 2^Bits - 1)
+    // the limbs are 64-bit and a plain array inside the object, so there's no heap, no size to check and no normalizing;
+    // on x86-64 each limb of + and - is one adc/sbb instruction: with g++ -O3 adding two 256-bit numbers becomes add + 3 adc,
+    // at -O2 g++ keeps the 4-step loop and saves the carry in a register between the adc instructions (still no branches)
+    // - StringAsNumber needs a heap array and loops with sizes only known at run time
+    // C++14 doesn't allow the add-with-carry intrinsics in constexpr functions, and can't tell whether a call is evaluated
+    // at compile time, so + and - come in two versions: the operators use the intrinsics and only work at run time,
+    // while sum() and difference() compute the carries with comparisons and are constexpr; everything else is constexpr too,
+    // so a constant like FixedInt<256>(1) << 200 is computed by the compiler
+    static_assert(Bits > 0 && Bits % 64 == 0, "FixedInt needs a (positive) multiple of 64 bits");
+
+    private:
+        typedef unsigned long long Limb;
+        static const int LIMB_COUNT = Bits / 64;
+
+        Limb limbs[LIMB_COUNT]; // least significant one first, like in StringAsNumber
+
+        static constexpr Limb addWithCarry(const Limb a, const Limb b, const unsigned char carryIn, unsigned char& carryOut) {
+            Limb sum = a + b;
+            Limb total = sum + carryIn;
+            carryOut = (unsigned char)((sum < a) | (total < sum)); // an unsigned sum wrapped around iff it got smaller
+            return total;
+        }
+
+        static constexpr Limb subtractWithBorrow(const Limb a, const Limb b, const unsigned char borrowIn, unsigned char& borrowOut) {
+            Limb difference = a - b;
+            borrowOut = (unsigned char)((a < b) | (difference < borrowIn));
+            return difference - borrowIn;
+        }
+
+        static constexpr Limb multiplyWide(const Limb a, const Limb b, Limb& high) { // a * b = high * 2^64 + the returned low half
+            // there's no 128-bit integer in standard C++ (and none at all on MSVC), so it's put together from 32 x 32-bit products
+            Limb low32 = 0xFFFFFFFFull;
+            Limb lowLow = (a & low32) * (b & low32);
+            Limb lowHigh = (a & low32) * (b >> 32);
+            Limb highLow = (a >> 32) * (b & low32);
+            Limb middle = (lowLow >> 32) + (lowHigh & low32) + (highLow & low32);
+            high = (a >> 32) * (b >> 32) + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+            return (middle << 32) | (lowLow & low32);
+        }
+
+    public:
+        constexpr FixedInt() : limbs{} { // 0
+        }
+
+        constexpr FixedInt(long long value) : limbs{} { // like converting an int to unsigned: negative values wrap around
+            Limb fill = value < 0 ? ~0ull : 0ull;
+            for (int i = 0; i < LIMB_COUNT; i++) {
+                this->limbs[i] = i == 0 ? (Limb)value : fill;
+            }
+        }
+
+        explicit FixedInt(const StringAsNumber& number) : limbs{} { // number modulo 2^Bits (so negative ones wrap around too)
+            for (int i = 0; i < 2 * LIMB_COUNT && i < number.size; i++) { // every limb here is two of StringAsNumber's
+                this->limbs[i / 2] |= (Limb)number.limbs[i] << (i % 2 * 32);
+            }
+            if (number.negative) {
+                *this = FixedInt() - *this;
+            }
+        }
+
+        StringAsNumber toNumber() const { // the same value as a StringAsNumber (always between 0 and 2^Bits - 1)
+            StringAsNumber::Limb halves[2 * LIMB_COUNT];
+            for (int i = 0; i < LIMB_COUNT; i++) {
+                halves[2 * i] = (StringAsNumber::Limb)this->limbs[i];
+                halves[2 * i + 1] = (StringAsNumber::Limb)(this->limbs[i] >> 32);
+            }
+            return StringAsNumber::fromLimbs(halves, 2 * LIMB_COUNT, 0, 2 * LIMB_COUNT);
+        }
+
+        std::string toString() const {
+            return this->toNumber().toString();
+        }
+
+        void printNumber() const {
+            std::cout << this->toString() << std::endl;
+        }
+
+        constexpr bool testBit(int bit) const { // bit number "bit" (bit 0 is the lowest one)
+            return bit >= 0 && bit < Bits && ((this->limbs[bit / 64] >> (bit % 64)) & 1);
+        }
+
+        constexpr int bitLength() const { // how many bits the value has (0 for 0)
+            for (int i = LIMB_COUNT - 1; i >= 0; i--) {
+                if (this->limbs[i]) {
+                    int bits = i * 64;
+                    for (Limb limb = this->limbs[i]; limb; limb >>= 1) {
+                        bits++;
+                    }
+                    return bits;
+                }
+            }
+            return 0;
+        }
+
+        constexpr bool operator==(const FixedInt& rhs) const {
+            for (int i = 0; i < LIMB_COUNT; i++) {
+                if (this->limbs[i] != rhs.limbs[i]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        constexpr bool operator!=(const FixedInt& rhs) const {
+            return !(*this == rhs);
+        }
+
+        constexpr bool operator<(const FixedInt& rhs) const {
+            for (int i = LIMB_COUNT - 1; i >= 0; i--) { // from the most significant limb down, like comparing strings
+                if (this->limbs[i] != rhs.limbs[i]) {
+                    return this->limbs[i] < rhs.limbs[i];
+                }
+            }
+            return false;
+        }
+
+        constexpr bool operator<=(const FixedInt& rhs) const {
+            return !(rhs < *this);
+        }
+
+        constexpr bool operator>(const FixedInt& rhs) const {
+            return rhs < *this;
+        }
 
-class StringAsNumber {
-    private:
-        char* number;
+        constexpr bool operator>=(const FixedInt& rhs) const {
+            return !(*this < rhs);
+        }
 
-        bool isNegative() const { // helper for checking if a number is negative
-            return this->number[0] == '-';
+        static constexpr FixedInt sum(const FixedInt& a, const FixedInt& b) { // a + b, usable at compile time
+            FixedInt out;
+            unsigned char carry = 0;
+            for (int i = 0; i < LIMB_COUNT; i++) {
+                out.limbs[i] = addWithCarry(a.limbs[i], b.limbs[i], carry, carry);
+            }
+            return out; // the carry out of the top limb is dropped, that's the wrap around
+        }
+
+        static constexpr FixedInt difference(const FixedInt& a, const FixedInt& b) { // a - b, usable at compile time
+            FixedInt out;
+            unsigned char borrow = 0;
+            for (int i = 0; i < LIMB_COUNT; i++) {
+                out.limbs[i] = subtractWithBorrow(a.limbs[i], b.limbs[i], borrow, borrow);
+            }
+            return out;
         }
 
-        char* digits() const { // helper for getting the actual digits of a number
-            char* tmp = nullptr;
-            int off = 0;
-            if (this->isNegative()) {
-                off = 1;
+        FixedInt& operator+=(const FixedInt& rhs) { // run time only (see the class comment), use sum() in constants
+#if defined(_M_X64) || defined(__x86_64__)
+            unsigned char carry = 0;
+            for (int i = 0; i < LIMB_COUNT; i++) {
+                carry = _addcarry_u64(carry, this->limbs[i], rhs.limbs[i], &this->limbs[i]);
             }
-            tmp = new char[strlen(this->number) + 1 - off];
-            strcpy(tmp, this->number + off);
-            return tmp;
+#else
+            *this = sum(*this, rhs); // no intrinsic on this platform, the comparisons do the same job a bit slower
+#endif
+            return *this;
         }
 
-        void normalize() { // helper for removing leading '0's from a string
-            bool negative = this->isNegative();
-            char* digits = this->digits();
+        FixedInt& operator-=(const FixedInt& rhs) { // run time only, use difference() in constants
+#if defined(_M_X64) || defined(__x86_64__)
+            unsigned char borrow = 0;
+            for (int i = 0; i < LIMB_COUNT; i++) {
+                borrow = _subborrow_u64(borrow, this->limbs[i], rhs.limbs[i], &this->limbs[i]);
+            }
+#else
+            *this = difference(*this, rhs);
+#endif
+            return *this;
+        }
 
-            int length = strlen(digits);
-            int start = 0;
-            // get length of leading '0's
-            while (start < length - 1 && digits[start] == '0') {
-                start++;
+        constexpr FixedInt& operator*=(const FixedInt& rhs) {
+            // school multiplication, keeping only the lowest LIMB_COUNT limbs (the others are multiples of 2^Bits)
+            FixedInt product;
+            for (int i = 0; i < LIMB_COUNT; i++) {
+                Limb carry = 0;
+                for (int j = 0; i + j < LIMB_COUNT; j++) {
+                    // limb * limb + limb + limb is at most 2^128 - 1, so the high half never overflows
+                    Limb high = 0;
+                    Limb low = multiplyWide(this->limbs[i], rhs.limbs[j], high);
+                    unsigned char first = 0;
+                    unsigned char second = 0;
+                    low = addWithCarry(low, product.limbs[i + j], 0, first);
+                    low = addWithCarry(low, carry, 0, second);
+                    product.limbs[i + j] = low;
+                    carry = high + first + second;
+                }
             }
+            *this = product;
+            return *this;
+        }
+
+        constexpr void divmod(const FixedInt& rhs, FixedInt& quotient, FixedInt& remainder) const {
+            // school long division in base 2: bring down one bit at a time, and subtract the divisor when it fits
+            // (a fixed number of steps, which is fine for the sizes this type is meant for)
+            if (rhs == FixedInt()) {
+                throw "Cannot divide by zero!";
+            }
+            FixedInt q;
+            FixedInt r;
+            for (int bit = this->bitLength() - 1; bit >= 0; bit--) {
+                r <<= 1;
+                r.limbs[0] |= this->testBit(bit);
+                if (r >= rhs) {
+                    r = difference(r, rhs);
+                    q.limbs[bit / 64] |= 1ull << (bit % 64);
+                }
+            }
+            quotient = q;
+            remainder = r;
+        }
 
-            int newLength = length - start;
-            int total = newLength + (negative ? 1 : 0) + 1; // calculate total length
+        constexpr FixedInt& operator/=(const FixedInt& rhs) {
+            FixedInt remainder;
+            this->divmod(rhs, *this, remainder);
+            return *this;
+        }
 
-            char* tmp = new char[total];
-            int pos = 0;
+        constexpr FixedInt& operator%=(const FixedInt& rhs) {
+            FixedInt quotient;
+            this->divmod(rhs, quotient, *this);
+            return *this;
+        }
 
-            if (negative) {
-                tmp[pos] = '-';
-                pos++;
+        constexpr FixedInt& operator<<=(int count) { // multiplies by 2^count (bits shifted out of the top are lost)
+            int whole = count / 64;
+            int bits = count % 64;
+            for (int i = LIMB_COUNT - 1; i >= 0; i--) {
+                Limb high = i - whole >= 0 ? this->limbs[i - whole] : 0;
+                Limb low = i - whole - 1 >= 0 ? this->limbs[i - whole - 1] : 0;
+                this->limbs[i] = bits ? (high << bits) | (low >> (64 - bits)) : high;
             }
-            // copy remaining digits
-            for (int i = start; i < length; i++) {
-                tmp[pos] = digits[i];
-                pos++;
+            return *this;
+        }
+
+        constexpr FixedInt& operator>>=(int count) { // divides by 2^count
+            int whole = count / 64;
+            int bits = count % 64;
+            for (int i = 0; i < LIMB_COUNT; i++) {
+                Limb low = i + whole < LIMB_COUNT ? this->limbs[i + whole] : 0;
+                Limb high = i + whole + 1 < LIMB_COUNT ? this->limbs[i + whole + 1] : 0;
+                this->limbs[i] = bits ? (low >> bits) | (high << (64 - bits)) : low;
             }
+            return *this;
+        }
+
+        // the regular operators copy *this (just an array on the stack) and use the compound ones
+        FixedInt operator+(const FixedInt& rhs) const {
+            FixedInt out = *this;
+            return out += rhs;
+        }
+
+        FixedInt operator-(const FixedInt& rhs) const {
+            FixedInt out = *this;
+            return out -= rhs;
+        }
+
+        constexpr FixedInt operator*(const FixedInt& rhs) const {
+            FixedInt out = *this;
+            return out *= rhs;
+        }
+
+        constexpr FixedInt operator/(const FixedInt& rhs) const {
+            FixedInt out = *this;
+            return out /= rhs;
+        }
+
+        constexpr FixedInt operator%(const FixedInt& rhs) const {
+            FixedInt out = *this;
+            return out %= rhs;
+        }
+
+        constexpr FixedInt operator<<(int count) const {
+            FixedInt out = *this;
+            return out <<= count;
+        }
+
+        constexpr FixedInt operator>>(int count) const {
+            FixedInt out = *this;
+            return out >>= count;
+        }
+};
+
+// checked by the compiler: 2^255 is computed at compile time, and wraps around to 0 when doubled
+static_assert(((FixedInt<256>(1) << 255) >> 255) == FixedInt<256>(1), "FixedInt shifts");
+static_assert(FixedInt<256>::sum(FixedInt<256>(1) << 255, FixedInt<256>(1) << 255) == FixedInt<256>(), "FixedInt wraps around");
+static_assert(FixedInt<128>::sum(FixedInt<128>(-1) >> 64, FixedInt<128>(1)) == FixedInt<128>(1) << 64, "FixedInt carries");
+static_assert(FixedInt<128>::difference(FixedInt<128>(), FixedInt<128>(1)) == FixedInt<128>(-1), "FixedInt borrows");
+static_assert(FixedInt<128>(-1) * FixedInt<128>(-1) == FixedInt<128>(1), "FixedInt multiplication");
+static_assert(FixedInt<128>(1000000007) * FixedInt<128>(998244353) / FixedInt<128>(998244353) == FixedInt<128>(1000000007), "FixedInt division");
+static_assert((FixedInt<128>(1) << 64) * (FixedInt<128>(1) << 63) == FixedInt<128>(1) << 127, "FixedInt multiplication across limbs");
+
+enum class RoundingMode { // what to do with the digits which don't fit in the scale of a result
+    DOWN, // towards zero (just cut them off): 2.7 -> 2, -2.7 -> -2
+    UP, // away from zero: 2.1 -> 3, -2.1 -> -3
+    FLOOR, // towards minus infinity: 2.7 -> 2, -2.1 -> -3
+    CEILING, // towards plus infinity: 2.1 -> 3, -2.7 -> -2
+    HALF_UP, // to the nearest one, and halves away from zero: 2.5 -> 3, -2.5 -> -3
+    HALF_DOWN, // to the nearest one, and halves towards zero: 2.5 -> 2, -2.5 -> -2
+    HALF_EVEN // to the nearest one, and halves to the even neighbour (the "banker's rounding"): 2.5 -> 2, 3.5 -> 4
+};
+
+class BigDecimal { // a decimal number with any number of digits, like 12345.6789, with no binary rounding errors
+    // stored as a big integer and a scale (the number of digits after the point): 12345.6789 = 123456789 / 10^4
+    // so 0.1 is exactly 1 / 10^1, unlike with double, where it's the nearest binary fraction and sums drift away
+    // addition, subtraction and multiplication are exact (the scale grows as needed); division can't always be exact
+    // (1 / 3), so it takes the scale of the result and a rounding mode, just like rescaling with setScale()
+    private:
+        StringAsNumber unscaled;
+        int scale;
+
+        static const int POWER_CACHE = 64;
 
-            tmp[pos] = '\0'; // null-terminate the new string
-            // make this tmp as our new number
-            delete[] this->number;
-            delete[] digits; // cleanup the memory allocated by "digits"
-            digits = nullptr;
-            this->number = tmp;
+        struct PowerTable { // 10^0 .. 10^(POWER_CACHE - 1)
+            StringAsNumber powers[POWER_CACHE];
 
-            // sanity check
-            if (strcmp(this->number, "-0") == 0 || strcmp(this->number, "0") == 0) {
-                delete[] this->number;
-                this->number = new char[2];
-                this->number[0] = '0';
-                this->number[1] = '\0';
+            PowerTable() {
+                this->powers[0] = StringAsNumber::fromInteger(1);
+                for (int i = 1; i < POWER_CACHE; i++) {
+                    this->powers[i] = this->powers[i - 1] * StringAsNumber::fromInteger(10);
+                }
+            }
+        };
+
+        static StringAsNumber powerOfTen(int exponent) { // 10^exponent; the small ones are computed once and kept
+            // all of them are filled in by the constructor of a function-local static, which C++ runs exactly once,
+            // even if several threads get here first at the same time
+            static const PowerTable cache;
+            if (exponent < POWER_CACHE) {
+                return cache.powers[exponent];
             }
+            // square-and-multiply: 10^(2k) = (10^k)^2 and 10^(2k + 1) = (10^k)^2 * 10
+            StringAsNumber half = powerOfTen(exponent / 2);
+            StringAsNumber out = half * half;
+            if (exponent % 2) {
+                out *= StringAsNumber::fromInteger(10);
+            }
+            return out;
+        }
+
+        static bool isNegative(const StringAsNumber& number) {
+            return number < StringAsNumber();
         }
 
-        int compareAbs(const char* lhs, const char* rhs) const {
-            // compare in absolute values (used only on buffers which have their '-' removed via "digits" function)
-            int lenLhs = strlen(lhs);
-            int lenRhs = strlen(rhs);
-            // check their lengths
-            // this is required as strcmp compares strings lexicographically, and if we check "9" and "10", we would get that "9" is bigger than "10"
-            // as '9' > '1'
-            // therefore, we need to ensure the strings are the same length
-            if (lenLhs < lenRhs) {
-                return -1;
+        static StringAsNumber abs(const StringAsNumber& number) {
+            return isNegative(number) ? StringAsNumber() - number : number;
+        }
+
+        static StringAsNumber divideRounded(const StringAsNumber& dividend, const StringAsNumber& divisor, RoundingMode mode) {
+            // dividend / divisor, rounded to an integer the way "mode" says
+            StringAsNumber quotient;
+            StringAsNumber remainder;
+            dividend.divmod(divisor, quotient, remainder); // rounded towards zero, so DOWN is already done
+            if (remainder == StringAsNumber()) {
+                return quotient;
+            }
+            bool negative = isNegative(dividend) != isNegative(divisor);
+            // how the dropped part compares to a half: 2 * |remainder| against |divisor|
+            StringAsNumber twice = abs(remainder);
+            twice += twice;
+            StringAsNumber magnitude = abs(divisor);
+            bool awayFromZero = false;
+            switch (mode) {
+                case RoundingMode::DOWN:
+                    awayFromZero = false;
+                    break;
+                case RoundingMode::UP:
+                    awayFromZero = true;
+                    break;
+                case RoundingMode::FLOOR:
+                    awayFromZero = negative;
+                    break;
+                case RoundingMode::CEILING:
+                    awayFromZero = !negative;
+                    break;
+                case RoundingMode::HALF_UP:
+                    awayFromZero = twice >= magnitude;
+                    break;
+                case RoundingMode::HALF_DOWN:
+                    awayFromZero = twice > magnitude;
+                    break;
+                case RoundingMode::HALF_EVEN:
+                    awayFromZero = twice > magnitude || (twice == magnitude && quotient.testBit(0));
+                    break;
+            }
+            if (awayFromZero) {
+                quotient += StringAsNumber::fromInteger(negative ? -1 : 1);
             }
-            if (lenLhs > lenRhs) {
-                return 1;
+            return quotient;
+        }
+
+        StringAsNumber unscaledAt(int newScale) const { // the unscaled value for a bigger (or the same) scale, which is exact
+            if (newScale == this->scale) {
+                return this->unscaled;
             }
-            // if same length, do a pure strcmp
-            return strcmp(lhs, rhs);
+            return this->unscaled * powerOfTen(newScale - this->scale);
         }
 
     public:
-        StringAsNumber() { // default constructor
-            this->number = new char[2];
-            this->number[0] = '0';
-            this->number[1] = '\0';
+        BigDecimal() { // 0
+            this->scale = 0;
         }
 
-        StringAsNumber(const char* number) { // parametrized constructor
-            bool ok = true;
+        BigDecimal(const StringAsNumber& unscaled, int scale) { // unscaled / 10^scale
+            this->unscaled = unscaled;
+            this->scale = scale;
+            if (this->scale < 0) { // a negative scale would mean trailing zeros, so just write them out
+                this->unscaled *= powerOfTen(-this->scale);
+                this->scale = 0;
+            }
+        }
 
-            if (!number || number[0] == '\0') { // if not a valid src array
-                ok = false;
+        BigDecimal(const char* text) { // parses "123", "-0.05", "1234.5600" (the scale is the number of digits after the point)
+            this->scale = 0;
+            std::string digits;
+            bool valid = text && text[0] != '\0';
+            int position = 0;
+            if (valid && text[0] == '-') {
+                digits += '-';
+                position = 1;
             }
-            else {
-                int len = strlen(number);
-                int start = 0;
-                bool hasSign = false;
-
-                // check for leading '-'
-                if (number[0] == '-') {
-                    hasSign = true;
-                    start = 1;
-
-                    // string must not be only "-"
-                    if (len == 1) {
-                        ok = false;
-                    }
+            int before = 0; // digits before the point
+            int after = -1; // digits after the point (-1 = no point)
+            for (; valid && text[position] != '\0'; position++) {
+                char c = text[position];
+                if (c == '.' && after < 0) {
+                    after = 0;
                 }
-                for (int i = start; i < strlen(number); i++) {
-                    if (number[i] < '0' || number[i] > '9') { // validate that we only get numbers as strings
-                        // in the ascii table, we get the digits one after the other, starting at number 48 (0x30), which is '0'
-                        // up to 57 (0x39), which is '9'
-                        // therefore, anything smaller than 0x30 or bigger than 0x39 would not be a digit
-                        ok = false;
-                        break;
+                else if (c >= '0' && c <= '9') {
+                    digits += c;
+                    if (after < 0) {
+                        before++;
+                    }
+                    else {
+                        after++;
                     }
                 }
+                else {
+                    valid = false;
+                }
             }
-            if (ok) {
-                this->number = new char[strlen(number) + 1];
-                strcpy(this->number, number);
-                this->normalize();
-            }
-            else {
+            if (!valid || before == 0 || after == 0) { // "-", ".5" and "5." aren't accepted
                 std::cout << "Invalid number!" << std::endl;
-                // default init in this case
-                this->number = new char[2];
-                this->number[0] = '0';
-                this->number[1] = '\0';
+                return;
             }
+            this->unscaled = StringAsNumber(digits.c_str());
+            this->scale = after > 0 ? after : 0;
         }
 
-        StringAsNumber(const StringAsNumber& other) { // copy constructor
-            // no need for size checks since in the other constructors we allocate something in all cases
-            this->number = new char[strlen(other.number) + 1];
-            strcpy(this->number, other.number);
+        static BigDecimal fromInteger(long long value) {
+            return BigDecimal(StringAsNumber::fromInteger(value), 0);
         }
 
-        ~StringAsNumber() { // destructor
-            delete[] this->number;
-            this->number = nullptr;
+        const StringAsNumber& getUnscaled() const {
+            return this->unscaled;
         }
 
-        StringAsNumber& operator=(const StringAsNumber& other) { // copy-assignment operator - marks the rule of three complete
-            // as we have all three (copy constructor, destructor and copy-assignment operator)
-            if (this != &other) { // guard against self-assignment
-                delete[] this->number; // it is safe not to check here, since we allocate this->number in all cases
-                this->number = new char[strlen(other.number) + 1];
-                strcpy(this->number, other.number);
+        int getScale() const {
+            return this->scale;
+        }
+
+        BigDecimal setScale(int newScale, RoundingMode mode) const { // the same number with "newScale" digits after the point
+            if (newScale < 0) {
+                std::cout << "The scale can't be negative, using 0!" << std::endl;
+                newScale = 0;
             }
-            return *this;
+            if (newScale >= this->scale) { // more digits: just append zeros
+                return BigDecimal(this->unscaledAt(newScale), newScale);
+            }
+            return BigDecimal(divideRounded(this->unscaled, powerOfTen(this->scale - newScale), mode), newScale);
         }
 
-        bool operator==(const StringAsNumber& rhs) const {
-            return strcmp(this->number, rhs.number) == 0;
+        std::string toString() const {
+            std::string digits = this->unscaled.toString();
+            bool negative = digits[0] == '-';
+            if (negative) {
+                digits.erase(0, 1);
+            }
+            if (this->scale > 0) {
+                if ((int)digits.size() <= this->scale) { // 0.00123: pad with '0's, so there's a digit before the point
+                    digits.insert(0, this->scale + 1 - digits.size(), '0');
+                }
+                digits.insert(digits.size() - this->scale, 1, '.');
+            }
+            return negative ? "-" + digits : digits;
         }
 
-        bool operator!=(const StringAsNumber& rhs) const {
-            return !(*this == rhs);
+        void printNumber() const {
+            std::cout << this->toString() << std::endl;
         }
 
-        bool operator<(const StringAsNumber& rhs) const {
-            bool leftNeg = this->isNegative();
-            bool rightNeg = rhs.isNegative();
+        int compare(const BigDecimal& rhs) const { // -1, 0 or 1, like strcmp (1.5 and 1.50 are equal)
+            int common = this->scale > rhs.scale ? this->scale : rhs.scale;
+            StringAsNumber lhsValue = this->unscaledAt(common);
+            StringAsNumber rhsValue = rhs.unscaledAt(common);
+            return lhsValue < rhsValue ? -1 : lhsValue == rhsValue ? 0 : 1;
+        }
 
-            // simple checks for sign mismatches
-            if (leftNeg && !rightNeg) {
-                return true;
-            }
-            if (!leftNeg && rightNeg) {
-                return false;
-            }
+        bool operator==(const BigDecimal& rhs) const {
+            return this->compare(rhs) == 0;
+        }
 
-            char* currDigits = this->digits();
-            char* rhsDigits = rhs.digits();
-            int cmp = this->compareAbs(currDigits, rhsDigits);
-            // cleanup for the arrays obtained via "digits()"
-            delete[] currDigits;
-            currDigits = nullptr;
-            delete[] rhsDigits;
-            rhsDigits = nullptr;
+        bool operator!=(const BigDecimal& rhs) const {
+            return this->compare(rhs) != 0;
+        }
 
-            // if both are negative
-            //      if cmp > 0 <=> leftHandSide is bigger than the rightHandSide
-            //          when adding back the negatives, the signs will flip, and therefore leftHandSide will be smaller than rightHandSide
-            //          which makes the operator return true, since we have "operator<"
-            // if both are positive
-            //      if cmp < 0 <=> leftHandSide is smaller than rightHandSide, which makes this operator return true
-            return leftNeg && rightNeg ? (cmp > 0 ? true : false) : (cmp < 0 ? true : false);
+        bool operator<(const BigDecimal& rhs) const {
+            return this->compare(rhs) < 0;
         }
 
-        bool operator<=(const StringAsNumber& rhs) const {
-            return *this < rhs || *this == rhs;
+        bool operator<=(const BigDecimal& rhs) const {
+            return this->compare(rhs) <= 0;
         }
 
-        bool operator>(const StringAsNumber& rhs) const {
-            return !(*this <= rhs);
+        bool operator>(const BigDecimal& rhs) const {
+            return this->compare(rhs) > 0;
         }
 
-        bool operator>=(const StringAsNumber& rhs) const {
-            return !(*this < rhs);
+        bool operator>=(const BigDecimal& rhs) const {
+            return this->compare(rhs) >= 0;
         }
 
-        StringAsNumber operator+(const StringAsNumber& rhs) const {
-            bool leftNeg = this->isNegative();
-            bool rightNeg = rhs.isNegative();
+        // exact results: the scale of a sum is the bigger one of the two, the scale of a product is their sum
+        BigDecimal operator+(const BigDecimal& rhs) const {
+            int common = this->scale > rhs.scale ? this->scale : rhs.scale;
+            return BigDecimal(this->unscaledAt(common) + rhs.unscaledAt(common), common);
+        }
 
-            // translate additions to their respective subtractions if the signs mismatch
-            if (leftNeg && !rightNeg) {
-                // -a + b = b - a
-                // needed those things here so we don't allocate them and then return, which would leave them allocated and not cleared
-                // with nobody to clear them
-                char* lhsDigits = this->digits();
-                StringAsNumber temp(lhsDigits);
-                delete[] lhsDigits;
-                lhsDigits = nullptr;
-                return rhs - temp;
-            }
+        BigDecimal operator-(const BigDecimal& rhs) const {
+            int common = this->scale > rhs.scale ? this->scale : rhs.scale;
+            return BigDecimal(this->unscaledAt(common) - rhs.unscaledAt(common), common);
+        }
 
-            if (!leftNeg && rightNeg) {
-                // a + (-b) = a - b
-                char* rhsDigits = rhs.digits();
-                StringAsNumber temp(rhsDigits);
-                delete[] rhsDigits;
-                rhsDigits = nullptr;
-                return *this - temp;
-            }
-
-            char* lhsDigits = this->digits();
-            char* rhsDigits = rhs.digits();
-            int lhsLen = strlen(lhsDigits);
-            int rhsLen = strlen(rhsDigits);
-            int size = (lhsLen > rhsLen ? lhsLen : rhsLen) + 1; // allocate +1 just in case of carry
-
-            char* result = new char[size + 1];
-            result[size] = '\0'; // null-terminate the result
-            // start from the end so we don't have to reverse the string at the end
-            int lhsPos = lhsLen - 1;
-            int rhsPos = rhsLen - 1;
-            int resPos = size - 1;
-            int carry = 0;
-
-            while (resPos >= 0) {
-                // do simple school addition algorithm
-                // add each digit with the one from the same position from the other number
-                // note down the result, and add the carry to the next addition
-                
-                // give them default values in case we run out of digits for a number
-                int lhsDigit = 0;
-                int rhsDigit = 0;
-
-                if (lhsPos >= 0) { // bounds check
-                    lhsDigit = lhsDigits[lhsPos] - '0'; // convert to int
-                    // for e.g., if we have '7' - '0', that equates to 55 (0x37) - 48 (0x30) which is 7
-                }
-                if (rhsPos >= 0) {
-                    rhsDigit = rhsDigits[rhsPos] - '0';
-                }
-
-                int sum = lhsDigit + rhsDigit + carry; // add carry from previous round
-                // (in case we have a carry at the end, giving "lhsDigit" and "rhsDigit" default values and allocating the result with size + 1
-                // ensures that we get the final value
-                carry = sum / 10; // get carry from this round, to be used in the next
-
-                result[resPos] = (sum % 10) + '0'; // convert back to the respective number as a character array
-                // move simultaneously
-                lhsPos--;
-                rhsPos--;
-                resPos--;
-            }
-
-            StringAsNumber out(result);
-            // cleanup
-            delete[] result;
-            result = nullptr;
-            delete[] lhsDigits;
-            lhsDigits = nullptr;
-            delete[] rhsDigits;
-            rhsDigits = nullptr;
-
-            if (leftNeg && rightNeg) { // if both negative, then addition is also negative
-                char* tmp = new char[strlen(out.number) + 2];
-                tmp[0] = '-';
-                strcpy(tmp + 1, out.number);
-                delete[] out.number;
-                out.number = tmp;
+        BigDecimal operator*(const BigDecimal& rhs) const {
+            return BigDecimal(this->unscaled * rhs.unscaled, this->scale + rhs.scale);
+        }
+
+        BigDecimal& operator+=(const BigDecimal& rhs) { // in place when the scales are the same, which is the common case for sums
+            if (rhs.scale == this->scale) {
+                this->unscaled += rhs.unscaled;
             }
-            return out;
+            else {
+                *this = *this + rhs;
+            }
+            return *this;
         }
 
-        StringAsNumber operator-(const StringAsNumber& rhs) const {
-            bool leftNeg = this->isNegative();
-            bool rightNeg = rhs.isNegative();
+        BigDecimal& operator-=(const BigDecimal& rhs) {
+            if (rhs.scale == this->scale) {
+                this->unscaled -= rhs.unscaled;
+            }
+            else {
+                *this = *this - rhs;
+            }
+            return *this;
+        }
 
-            // translate subtractions to their respective additions if signs mismatch
-            if (leftNeg && !rightNeg) {
-                char* lhsDigits = this->digits();
-                StringAsNumber temp(lhsDigits);
-                StringAsNumber res = temp + rhs;
+        // the same operations with a given scale for the result, rounded the way "mode" says
+        BigDecimal add(const BigDecimal& rhs, int resultScale, RoundingMode mode) const {
+            return (*this + rhs).setScale(resultScale, mode);
+        }
 
-                char* tmp = new char[strlen(res.number) + 2];
-                // -a - b = - (a + b)
-                tmp[0] = '-';
-                strcpy(tmp + 1, res.number);
-                delete[] res.number;
-                res.number = tmp;
-                delete[] lhsDigits;
-                lhsDigits = nullptr;
+        BigDecimal multiply(const BigDecimal& rhs, int resultScale, RoundingMode mode) const {
+            return (*this * rhs).setScale(resultScale, mode);
+        }
 
-                return res;
+        BigDecimal divide(const BigDecimal& rhs, int resultScale, RoundingMode mode) const {
+            // (a / 10^s) / (b / 10^t) = a * 10^(t - s) / b, and the result needs "resultScale" more digits:
+            // result = a * 10^(resultScale + t - s) / b, with a single rounding at the end
+            if (rhs.unscaled == StringAsNumber()) {
+                throw "Cannot divide by zero!";
             }
-
-            if (!leftNeg && rightNeg) {
-                // a - (-b) = a + b
-                char* rhsDigits = rhs.digits();
-                StringAsNumber temp(rhsDigits);
-                StringAsNumber res = *this + temp;
-                delete[] rhsDigits;
-                rhsDigits = nullptr;
-                return res;
-            }
-
-            char* lhsDigits = this->digits();
-            char* rhsDigits = rhs.digits();
-            // simple check for fast exits
-            int cmp = this->compareAbs(lhsDigits, rhsDigits);
-            if (cmp == 0) {
-                // if both negative, i.e. -a - (-a) = -a + a = 0
-                // if both positive, i.e. a - a = 0
-                // cleanup before return
-                delete[] lhsDigits;
-                lhsDigits = nullptr;
-                delete[] rhsDigits;
-                rhsDigits = nullptr;
-                return StringAsNumber("0");
-            }
-
-            bool negative = false;
-            const char* big = lhsDigits;
-            const char* small = rhsDigits;
-            if (cmp < 0) {
-                // swap values in case the result is negative (if a < b <=> a - b < 0)
-                negative = true;
-                big = rhsDigits;
-                small = lhsDigits;
-            }
-
-            int bigLen = strlen(big);
-            int smallLen = strlen(small);
-            char* result = new char[bigLen + 1];
-            result[bigLen] = '\0';
-
-            // start again from the end so we don't have to reverse the string at the end
-            int bigPos = bigLen - 1;
-            int smallPos = smallLen - 1;
-            int resPos = bigLen - 1;
-            int borrow = 0;
-            while (resPos >= 0) {
-                // do regular subtraction algorithm
-                // subtract each digit from the other one
-                // if the result is negative, then borrow one from the next position and then subtract it from there when reaching its calculation
-                int bigDigit = big[bigPos] - '0' - borrow;
-                int smallDigit = 0;
-
-                if (smallPos >= 0) {
-                    smallDigit = small[smallPos] - '0';
-                }
-                if (bigDigit < smallDigit) {
-                    bigDigit += 10;
-                    borrow = 1;
-                }
-                else {
-                    borrow = 0;
-                }
-
-                result[resPos] = (bigDigit - smallDigit) + '0';
-                bigPos--;
-                smallPos--;
-                resPos--;
+            if (resultScale < 0) {
+                std::cout << "The scale can't be negative, using 0!" << std::endl;
+                resultScale = 0;
             }
+            int shift = resultScale + rhs.scale - this->scale;
+            if (shift >= 0) {
+                return BigDecimal(divideRounded(this->unscaled * powerOfTen(shift), rhs.unscaled, mode), resultScale);
+            }
+            return BigDecimal(divideRounded(this->unscaled, rhs.unscaled * powerOfTen(-shift), mode), resultScale);
+        }
 
-            StringAsNumber out(result);
-            delete[] result;
-            result = nullptr;
-            delete[] lhsDigits;
-            lhsDigits = nullptr;
-            delete[] rhsDigits;
-            rhsDigits = nullptr;
-            big = small = nullptr; // big = (small = nullptr) <=> do small = nullptr, then do big = small, which also makes big be nullptr
-            // also make these ones nullptr, since they are copies of "lhsDigits" and "rhsDigits"
-            // not reallocated, just using the same address
-            // so we don't de-allocate them since that'd be a double-free, but we just make them null to not leave them dangling
+        static BigDecimal sum(const BigDecimal* values, int count); // the exact sum of many values (defined below, with DecimalAccumulator)
+};
 
-            if (leftNeg && rightNeg) {
-                // -a - (-b) = -a + b = b - a = - (a - b)
-                negative = !negative;
-            }
+class DecimalAccumulator { // adds up many BigDecimals into a single running total
+    // the total is one StringAsNumber at a fixed scale, updated in place with +=, so adding a value with the same scale
+    // (e.g. amounts in cents) costs one pass over the limbs and no allocation - instead of a new BigDecimal for every partial sum
+    // a value with more digits after the point raises the scale of the total first, so the sum stays exact
+    private:
+        StringAsNumber total;
+        int scale;
 
-            if (negative) { // if result is negative
-                char* tmp = new char[strlen(out.number) + 2];
-                tmp[0] = '-';
-                strcpy(tmp + 1, out.number);
-                delete[] out.number;
-                out.number = tmp;
-            }
-            return out;
+    public:
+        DecimalAccumulator(int scale = 0) {
+            this->scale = scale < 0 ? 0 : scale;
         }
 
-        StringAsNumber operator*(const StringAsNumber& rhs) const {
-            // check for multiplication with zero
-            if (*this == StringAsNumber("0") || rhs == StringAsNumber("0")) {
-                return StringAsNumber("0");
+        void add(const BigDecimal& value) {
+            if (value.getScale() > this->scale) {
+                this->total = BigDecimal(this->total, this->scale).setScale(value.getScale(), RoundingMode::DOWN).getUnscaled();
+                this->scale = value.getScale();
+            }
+            if (value.getScale() == this->scale) {
+                this->total += value.getUnscaled();
+            }
+            else {
+                this->total += value.setScale(this->scale, RoundingMode::DOWN).getUnscaled(); // exact, since the scale only grows
             }
+        }
 
-            // check for sign mismatches
-            bool negative = false;
-            if (this->isNegative() != rhs.isNegative()) {
-                negative = true;
+        void add(const BigDecimal* values, int count) {
+            for (int i = 0; i < count; i++) {
+                this->add(values[i]);
             }
+        }
 
-            char* lhsDigits = this->digits();
-            char* rhsDigits = rhs.digits();
-            int lhsLen = strlen(lhsDigits);
-            int rhsLen = strlen(rhsDigits);
+        BigDecimal getSum() const {
+            return BigDecimal(this->total, this->scale);
+        }
 
-            // result can have at most lhsLen + rhsLen digits
-            char* result = new char[lhsLen + rhsLen + 1];
-            memset(result, 48, lhsLen + rhsLen);
-            result[lhsLen + rhsLen] = '\0';
+        void reset() {
+            this->total = StringAsNumber();
+        }
+};
 
-            // do regular school digit multiplication
-            // multiply digit by digit and then add them in the correct place
-            // go in reverse order so we don't have to reverse the string at the end
-            // there are multiple algorithms for multiplying and dividing, but we go with simple ones
-            for (int i = lhsLen - 1; i >= 0; i--) {
-                int carry = 0;
-                int lhsDigit = lhsDigits[i] - '0';
-                for (int j = rhsLen - 1; j >= 0; j--) {
-                    int rhsDigit = rhsDigits[j] - '0';
+BigDecimal BigDecimal::sum(const BigDecimal* values, int count) {
+    // start at the biggest scale of all the values, so the total never has to be rescaled
+    int biggest = 0;
+    for (int i = 0; i < count; i++) {
+        if (values[i].scale > biggest) {
+            biggest = values[i].scale;
+        }
+    }
+    DecimalAccumulator accumulator(biggest);
+    accumulator.add(values, count);
+    return accumulator.getSum();
+}
 
-                    int pos = (lhsLen - 1 - i) + (rhsLen - 1 - j); // current position in lhs + current position in rhs
-                    int index = (lhsLen + rhsLen - 1) - pos;
+class WorkerPool { // a fixed set of threads, started once and reused for many parallel loops (see parallelFor())
+    // starting a thread costs tens of microseconds, which is more than a lot of the multiplications in a product tree,
+    // so the threads are kept waiting on a condition variable between loops instead of being started for each one
+    private:
+        std::thread* threads;
+        int threadCount; // helper threads, besides the one which calls parallelFor()
+        std::mutex mutex;
+        std::condition_variable wake; // signalled when there's a new loop to run (or the pool is being destroyed)
+        std::condition_variable finished; // signalled when a helper thread is done with the current loop
+        const std::function<void(int)>* job;
+        int jobCount;
+        std::atomic<int> nextIteration;
+        int doneThreads; // helper threads done with the current loop
+        long long generation; // how many loops were started, so a thread knows when there's a new one
+        bool stopping;
+
+        void runIterations(const std::function<void(int)>& function, int count) {
+            // every thread takes the next iteration nobody has taken yet, until there are none left,
+            // so a thread which got quick ones simply does more of them
+            for (int i = this->nextIteration++; i < count; i = this->nextIteration++) {
+                function(i);
+            }
+        }
 
-                    int curr = (result[index] - '0') + lhsDigit * rhsDigit + carry;
-                    result[index] = (curr % 10) + '0';
-                    carry = curr / 10;
-                }
-                if (carry > 0) {
-                    int index = (lhsLen + rhsLen - 1) - ((lhsLen - 1 - i) + rhsLen);
-                    result[index] = (result[index] - '0' + carry) + '0';
+        void work() { // what every helper thread runs: wait for a loop, help with it, repeat
+            long long seen = 0;
+            std::unique_lock<std::mutex> lock(this->mutex);
+            while (true) {
+                this->wake.wait(lock, [&]() { return this->stopping || this->generation != seen; });
+                if (this->stopping) {
+                    return;
                 }
+                seen = this->generation;
+                const std::function<void(int)>& function = *this->job;
+                int count = this->jobCount;
+                lock.unlock();
+                this->runIterations(function, count);
+                lock.lock();
+                this->doneThreads++;
+                this->finished.notify_one();
             }
+        }
 
-            StringAsNumber out(result);
-            delete[] result;
-            result = nullptr;
-            delete[] lhsDigits;
-            lhsDigits = nullptr;
-            delete[] rhsDigits;
-            rhsDigits = nullptr;
-
-            if (negative) {
-                char* tmp = new char[strlen(out.number) + 2];
-                tmp[0] = '-';
-                strcpy(tmp + 1, out.number);
-                delete[] out.number;
-                out.number = tmp;
+    public:
+        WorkerPool(int threads = 0) { // the number of threads to use, counting the caller; 0 = one per core
+            if (threads <= 0) {
+                threads = (int)std::thread::hardware_concurrency();
+            }
+            this->threadCount = threads > 1 ? threads - 1 : 0;
+            this->job = nullptr;
+            this->jobCount = 0;
+            this->nextIteration = 0;
+            this->doneThreads = 0;
+            this->generation = 0;
+            this->stopping = false;
+            this->threads = this->threadCount > 0 ? new std::thread[this->threadCount] : nullptr;
+            for (int i = 0; i < this->threadCount; i++) {
+                this->threads[i] = std::thread(&WorkerPool::work, this);
             }
-            return out;
         }
 
+        WorkerPool(const WorkerPool&) = delete; // the threads point back to this object, so it can't be copied
+        WorkerPool& operator=(const WorkerPool&) = delete;
 
-        StringAsNumber operator/(const StringAsNumber& rhs) const {
-            // implement it as integer division, as we don't know yet how we can return 2 values beautifully other than using a list
-            if (rhs == StringAsNumber("0")) {
-                throw "Cannot divide by zero!"; // throw is a special statement, which invokes an error
-                // we give an error for this, since we cannot return anything in this case, and we want the program to crash
-                // in the future, we'll see how we can catch those and resume gracefully, but for now we don't do any catching
-                // and hence division by 0 will crash the program, just as it regularly does
+        ~WorkerPool() {
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->stopping = true;
             }
-            // simple check for fast exit
-            if (*this == StringAsNumber("0")) { // 0 / x = 0
-                return StringAsNumber("0");
+            this->wake.notify_all();
+            for (int i = 0; i < this->threadCount; i++) {
+                this->threads[i].join();
             }
+            delete[] this->threads;
+            this->threads = nullptr;
+        }
 
-            // check for sign mismatch
-            bool negative = false;
-            if (this->isNegative() != rhs.isNegative()) {
-                negative = true;
-            }
-
-            char* lhsDigits = this->digits();
-            char* rhsDigits = rhs.digits();
-            StringAsNumber left(lhsDigits);
-            StringAsNumber divisor(rhsDigits);
-            // cleanup
-            delete[] lhsDigits;
-            lhsDigits = nullptr;
-            delete[] rhsDigits;
-            rhsDigits = nullptr;
-
-            StringAsNumber zero("0");
-            StringAsNumber ten("10");
-            StringAsNumber quotient("0");
-            // chunked subtraction
-            // for e.g., if we do 216 / 6, we multiply 6 by multiples of 10, until it is bigger, then take the previous value
-            // subtract that and repeat, so we chunk and don't do that many subtractions
-            while (left >= divisor) {
-                StringAsNumber currentDivisor = divisor;
-                StringAsNumber multiple("1");
-                // multiply divisor by 10 as long as <= leftHandSide
-                while (true) {
-                    StringAsNumber next = currentDivisor * ten;
-                    if (next > left) {
-                        break;
-                    }
-                    currentDivisor = next;
-                    multiple = multiple * ten;
+        int getThreadCount() const {
+            return this->threadCount + 1;
+        }
+
+        void parallelFor(int count, const std::function<void(int)>& function) {
+            // function(0), ..., function(count - 1), spread over the threads of the pool (the caller helps too);
+            // returns once all of them are done, and the iterations must not depend on each other
+            if (this->threadCount == 0 || count <= 1) {
+                for (int i = 0; i < count; i++) {
+                    function(i);
                 }
-                left = left - currentDivisor;
-                quotient = quotient + multiple;
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->job = &function;
+                this->jobCount = count;
+                this->nextIteration = 0;
+                this->doneThreads = 0;
+                this->generation++;
             }
+            this->wake.notify_all();
+            this->runIterations(function, count);
+            // wait for every helper, not just for the iterations: one that woke up late must not look at the next loop's job
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->finished.wait(lock, [&]() { return this->doneThreads == this->threadCount; });
+        }
+};
 
-            if (negative && quotient != zero) {
-                char* tmp = new char[strlen(quotient.number) + 2];
-                tmp[0] = '-';
-                strcpy(tmp + 1, quotient.number);
-                delete[] quotient.number;
-                quotient.number = tmp;
+StringAsNumber productOf(const StringAsNumber* values, int count, WorkerPool& pool) {
+    // values[0] * values[1] * ... * values[count - 1] with a product tree: multiply neighbours in pairs, then the pairs
+    // in pairs, and so on; multiplying a long chain one value at a time makes the running product grow by one value each step,
+    // so the work is ~count^2; in the tree both operands of every multiplication have the same size, which the fast
+    // algorithms (Karatsuba, Toom-3, NTT) need to pay off
+    // the multiplications of one level don't depend on each other, so each level runs on all the threads of the pool
+    // (only the last few levels have fewer products than threads; the very last one is a single multiplication)
+    if (count <= 0) {
+        return StringAsNumber::fromInteger(1);
+    }
+    StringAsNumber* level = new StringAsNumber[count];
+    for (int i = 0; i < count; i++) {
+        level[i] = values[i];
+    }
+    int size = count;
+    while (size > 1) {
+        int pairs = size / 2;
+        StringAsNumber* next = new StringAsNumber[pairs + size % 2];
+        // a task per group of pairs instead of per pair, since the bottom levels have millions of tiny multiplications
+        int tasks = pairs < pool.getThreadCount() * 16 ? pairs : pool.getThreadCount() * 16;
+        pool.parallelFor(tasks, [&](int task) {
+            int first = (int)((long long)pairs * task / tasks);
+            int last = (int)((long long)pairs * (task + 1) / tasks);
+            for (int i = first; i < last; i++) {
+                next[i] = level[2 * i] * level[2 * i + 1];
             }
-            return quotient;
+        });
+        if (size % 2) { // the odd one out goes up a level as it is
+            next[pairs] = std::move(level[size - 1]);
         }
+        delete[] level;
+        level = next;
+        size = pairs + size % 2;
+    }
+    StringAsNumber product = std::move(level[0]);
+    delete[] level;
+    level = nullptr;
+    return product;
+}
 
-        // implement copy-assigment operators based on the already defined binary operators
-        StringAsNumber& operator+=(const StringAsNumber& rhs) {
-            *this = *this + rhs;
-            return *this;
+StringAsNumber factorial(int n, WorkerPool& pool) { // n! = 1 * 2 * ... * n, with productOf()
+    // as many consecutive factors as fit are first multiplied together in a regular integer (below 2^32, one limb),
+    // which makes the tree many times smaller at the bottom, where its multiplications are the least efficient
+    if (n < 0) {
+        std::cout << "Factorial of a negative number!" << std::endl;
+        return StringAsNumber();
+    }
+    StringAsNumber* factors = new StringAsNumber[n > 0 ? n : 1];
+    int count = 0;
+    unsigned long long group = 1;
+    for (int i = 2; i <= n; i++) {
+        if (group * i >= (1ull << 32)) {
+            factors[count] = StringAsNumber::fromInteger((long long)group);
+            count++;
+            group = 1;
         }
+        group *= i;
+    }
+    factors[count] = StringAsNumber::fromInteger((long long)group);
+    count++;
+    StringAsNumber product = productOf(factors, count, pool);
+    delete[] factors;
+    factors = nullptr;
+    return product;
+}
 
-        StringAsNumber& operator-=(const StringAsNumber& rhs) {
-            *this = *this - rhs;
-            return *this;
+StringAsNumber randomNumber(int digits, unsigned int& seed) { // a random positive number with (about) "digits" decimal digits
+    std::string text(digits, '0');
+    for (int i = 0; i < digits; i++) {
+        seed = seed * 1103515245 + 12345; // simple linear congruential generator, good enough for benchmarks
+        text[i] = (char)('0' + (seed >> 16) % 10);
+    }
+    if (text[0] == '0') {
+        text[0] = '1';
+    }
+    return StringAsNumber(text.c_str());
+}
+
+int digitsForLimbs(int limbs) { // each limb holds 32 * log10(2) ~ 9.63 decimal digits
+    return (int)(limbs * 9.63);
+}
+
+double timeMultiplication(const StringAsNumber& lhs, const StringAsNumber& rhs) { // time of lhs * rhs, in milliseconds
+    // repeat it until at least ~10ms have passed, so the measurement is not dominated by the timer resolution,
+    // and keep the best of 3 such rounds, so that being interrupted by something else doesn't count
+    double best = 0;
+    for (int round = 0; round < 3; round++) {
+        int repeats = 0;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        double elapsed = 0;
+        do {
+            StringAsNumber product = lhs * rhs;
+            repeats++;
+            elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        } while (elapsed < 10);
+        if (round == 0 || elapsed / repeats < best) {
+            best = elapsed / repeats;
         }
+    }
+    return best;
+}
 
-        StringAsNumber& operator*=(const StringAsNumber& rhs) {
-            *this = *this * rhs;
-            return *this;
+int findCrossover(const int* sizes, int count, int level, const int* thresholds) {
+    // the smallest size from which the algorithm of this level beats the one below it, twice in a row so that a single noisy
+    // measurement doesn't decide it; level 1 is Karatsuba (against school), 2 is Toom-3 and 3 is the NTT
+    // thresholds has the ones found for the levels below; the faster algorithm is only used at the top, since
+    // its pieces (half or a third of the size) fall below the threshold
+    const char* names[4] = { "school", "Karatsuba", "Toom-3", "NTT" };
+    unsigned int seed = 42;
+    int wins = 0;
+    for (int i = 0; i < count; i++) {
+        StringAsNumber lhs = randomNumber(digitsForLimbs(sizes[i]), seed);
+        StringAsNumber rhs = randomNumber(digitsForLimbs(sizes[i]), seed);
+        int size = lhs.getLimbCount() < rhs.getLimbCount() ? lhs.getLimbCount() : rhs.getLimbCount();
+        int tried[3];
+        for (int j = 0; j < 3; j++) {
+            tried[j] = j + 1 < level ? thresholds[j] : StringAsNumber::DISABLED;
         }
+        tried[level - 1] = size;
+        StringAsNumber::setMultiplyThresholds(tried[0], tried[1], tried[2]);
+        double fast = timeMultiplication(lhs, rhs);
+        tried[level - 1] = size + 1;
+        StringAsNumber::setMultiplyThresholds(tried[0], tried[1], tried[2]);
+        double slow = timeMultiplication(lhs, rhs);
+        std::cout << "    " << size << " limbs: " << names[level] << " " << fast << " ms, " << names[level - 1] << " " << slow << " ms" << std::endl;
+        wins = fast < slow ? wins + 1 : 0;
+        if (wins == 2) {
+            return sizes[i - 1];
+        }
+    }
+    return sizes[count - 1];
+}
 
-        StringAsNumber& operator/=(const StringAsNumber& rhs) {
-            *this = *this / rhs;
-            return *this;
+void tuneMultiplication() { // measures the thresholds for this machine and sets them
+    std::cout << "Tuning the multiplication thresholds..." << std::endl;
+    int thresholds[3] = { 0, 0, 0 };
+    const int karatsubaSizes[] = { 8, 12, 16, 20, 24, 32, 40, 48, 64, 80, 96, 128 };
+    thresholds[0] = findCrossover(karatsubaSizes, sizeof(karatsubaSizes) / sizeof(karatsubaSizes[0]), 1, thresholds);
+    const int toom3Sizes[] = { 60, 90, 120, 150, 200, 250, 300, 400, 500, 650, 800, 1000 };
+    thresholds[1] = findCrossover(toom3Sizes, sizeof(toom3Sizes) / sizeof(toom3Sizes[0]), 2, thresholds);
+    const int nttSizes[] = { 300, 400, 500, 750, 1000, 1500, 2000, 3000, 4000, 6000, 8000 };
+    thresholds[2] = findCrossover(nttSizes, sizeof(nttSizes) / sizeof(nttSizes[0]), 3, thresholds);
+    StringAsNumber::setMultiplyThresholds(thresholds[0], thresholds[1], thresholds[2]);
+    std::cout << "Karatsuba from " << thresholds[0] << " limbs, Toom-3 from " << thresholds[1] << " limbs, NTT from "
+        << thresholds[2] << " limbs" << std::endl;
+}
+
+void runMultiplicationBenchmark(int digits, int firstAlgorithm) {
+    // times one digits x digits multiplication with each algorithm, starting from firstAlgorithm
+    // (0 = school, 1 = Karatsuba, 2 = Toom-3, 3 = NTT), since the slow ones take too long on huge numbers
+    unsigned int seed = 7;
+    StringAsNumber lhs = randomNumber(digits, seed);
+    StringAsNumber rhs = randomNumber(digits, seed);
+    int thresholds[3] = { StringAsNumber::getKaratsubaThreshold(), StringAsNumber::getToom3Threshold(), StringAsNumber::getNttThreshold() };
+    const char* names[4] = { "School", "Karatsuba", "Toom-3", "NTT" };
+    StringAsNumber products[4];
+    for (int algorithm = firstAlgorithm; algorithm < 4; algorithm++) {
+        // turn off the algorithms we don't want by setting their threshold out of reach
+        StringAsNumber::setMultiplyThresholds(algorithm >= 1 ? thresholds[0] : StringAsNumber::DISABLED,
+            algorithm >= 2 ? thresholds[1] : StringAsNumber::DISABLED, algorithm >= 3 ? thresholds[2] : StringAsNumber::DISABLED);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        products[algorithm] = lhs * rhs;
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << names[algorithm] << ": " << digits << " x " << digits << " digits in " << elapsed << " ms" << std::endl;
+    }
+    StringAsNumber::setMultiplyThresholds(thresholds[0], thresholds[1], thresholds[2]);
+    bool match = true;
+    for (int algorithm = firstAlgorithm + 1; algorithm < 4; algorithm++) {
+        match = match && products[algorithm] == products[firstAlgorithm];
+    }
+    std::cout << (match ? "All products match" : "Products differ!") << std::endl;
+}
+
+void runDivisionBenchmark(int digits) { // times a 2 * digits / digits division with long division and with Newton's method
+    unsigned int seed = 11;
+    StringAsNumber dividend = randomNumber(2 * digits, seed);
+    StringAsNumber divisor = randomNumber(digits, seed);
+    int newton = StringAsNumber::getNewtonThreshold();
+    const char* names[2] = { "Long division", "Newton" };
+    StringAsNumber quotients[2];
+    StringAsNumber remainders[2];
+    for (int algorithm = 0; algorithm < 2; algorithm++) {
+        StringAsNumber::setNewtonThreshold(algorithm == 0 ? StringAsNumber::DISABLED : 2); // 2 = always Newton
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        dividend.divmod(divisor, quotients[algorithm], remainders[algorithm]);
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << names[algorithm] << ": " << 2 * digits << " / " << digits << " digits in " << elapsed << " ms" << std::endl;
+    }
+    StringAsNumber::setNewtonThreshold(newton);
+    bool match = quotients[0] == quotients[1] && remainders[0] == remainders[1] && quotients[0] * divisor + remainders[0] == dividend;
+    std::cout << (match ? "Quotients and remainders match" : "Divisions differ!") << std::endl;
+}
+
+template <typename Operation>
+double allocationsPerCall(Operation operation, int calls) { // how many times "operation" calls new, on average
+    long long before = allocationCount.load();
+    for (int i = 0; i < calls; i++) {
+        operation();
+    }
+    return (double)(allocationCount.load() - before) / calls;
+}
+
+void runAllocationBenchmark() { // allocations per operation, for numbers which fit in the inline buffer and for big ones
+    const int calls = 1000;
+    const char* sizeNames[2] = { "small (20 / 18 digits)", "big (2000 / 1000 digits)" };
+    const int digits[2][2] = { { 20, 18 }, { 2000, 1000 } };
+    std::cout << "Allocations per operation:" << std::endl;
+    for (int kind = 0; kind < 2; kind++) {
+        unsigned int seed = 5;
+        StringAsNumber a = randomNumber(digits[kind][0], seed);
+        StringAsNumber b = randomNumber(digits[kind][1], seed);
+        StringAsNumber x = a;
+        StringAsNumber quotient;
+        StringAsNumber remainder;
+        std::cout << "  " << sizeNames[kind] << ":" << std::endl;
+        std::cout << "    copy            " << allocationsPerCall([&]() { StringAsNumber copy(a); }, calls) << std::endl;
+        std::cout << "    move            " << allocationsPerCall([&]() { StringAsNumber moved(std::move(x)); x = std::move(moved); }, calls) << std::endl;
+        std::cout << "    a + b           " << allocationsPerCall([&]() { StringAsNumber sum = a + b; }, calls) << std::endl;
+        std::cout << "    x = x + b       " << allocationsPerCall([&]() { x = x + b; }, calls) << std::endl;
+        std::cout << "    x += b          " << allocationsPerCall([&]() { x += b; }, calls) << std::endl;
+        std::cout << "    x -= b          " << allocationsPerCall([&]() { x -= b; }, calls) << std::endl;
+        std::cout << "    a * b           " << allocationsPerCall([&]() { StringAsNumber product = a * b; }, calls) << std::endl;
+        std::cout << "    x = a; x *= b   " << allocationsPerCall([&]() { x = a; x *= b; }, calls) << std::endl;
+        std::cout << "    a / b           " << allocationsPerCall([&]() { StringAsNumber result = a / b; }, calls) << std::endl;
+        std::cout << "    a % b           " << allocationsPerCall([&]() { StringAsNumber result = a % b; }, calls) << std::endl;
+        std::cout << "    divmod          " << allocationsPerCall([&]() { a.divmod(b, quotient, remainder); }, calls) << std::endl;
+    }
+}
+
+void runConversionBenchmark(int digits) { // times reading and printing a decimal number with "digits" digits
+    unsigned int seed = 17;
+    std::string text(digits, '0');
+    for (int i = 0; i < digits; i++) {
+        seed = seed * 1103515245 + 12345;
+        text[i] = (char)('0' + (seed >> 16) % 10);
+    }
+    text[0] = '1';
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    StringAsNumber number(text.c_str());
+    double parsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    std::string printed = number.toString();
+    double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Decimal conversion of " << digits << " digits: parsing " << parsed << " ms, printing " << elapsed << " ms" << std::endl;
+    std::cout << (printed == text ? "Printed number matches the input" : "Printed number differs from the input!") << std::endl;
+}
+
+StringAsNumber powmodReference(const StringAsNumber& base, const StringAsNumber& exponent, const StringAsNumber& modulus) {
+    // the textbook square-and-multiply with % after every step, to check powmod() against (and to see how much faster it is)
+    StringAsNumber m = modulus < StringAsNumber() ? StringAsNumber() - modulus : modulus;
+    StringAsNumber result = StringAsNumber::fromInteger(1) % m;
+    StringAsNumber square = base % m;
+    if (square < StringAsNumber()) {
+        square += m;
+    }
+    for (int bit = 0; bit < exponent.bitLength(); bit++) { // the exponent bits from the lowest: square holds base^(2^bit)
+        if (exponent.testBit(bit)) {
+            result = result * square % m;
         }
+        square = square * square % m;
+    }
+    return result;
+}
 
-        void printNumber() const { // small public helper for printing the number
-            std::cout << this->number << std::endl;
+double timePowmod(StringAsNumber (*power)(const StringAsNumber&, const StringAsNumber&, const StringAsNumber&),
+    const StringAsNumber& base, const StringAsNumber& exponent, const StringAsNumber& modulus, StringAsNumber& result) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    result = power(base, exponent, modulus);
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+StringAsNumber barrettPowmod(const StringAsNumber& base, const StringAsNumber& exponent, const StringAsNumber& modulus) {
+    return BarrettReducer(modulus).power(base, exponent);
+}
+
+void runFixedIntBenchmark() { // FixedInt<256> against StringAsNumber: the same results, and how long additions take
+    const int count = 200;
+    const int additions = 10000000;
+    unsigned int seed = 19;
+    StringAsNumber modulus = FixedInt<256>(-1).toNumber() + StringAsNumber::fromInteger(1); // 2^256
+    bool match = true;
+    for (int i = 0; i < count; i++) {
+        StringAsNumber a = randomNumber(1 + i % 78, seed); // 2^256 has 78 digits
+        StringAsNumber b = randomNumber(1 + (i * 7) % 78, seed);
+        if (i % 3 == 0) {
+            a = StringAsNumber() - a; // negative numbers wrap around
         }
-};
+        FixedInt<256> x(a);
+        FixedInt<256> y(b);
+        StringAsNumber aWrapped = (a % modulus + modulus) % modulus;
+        StringAsNumber bWrapped = b % modulus; // 78 digit numbers can be above 2^256 too
+        match = match && x.toNumber() == aWrapped && y.toNumber() == bWrapped
+            && (x + y).toNumber() == (aWrapped + bWrapped) % modulus
+            && (x - y).toNumber() == (aWrapped - bWrapped + modulus) % modulus
+            && (x * y).toNumber() == aWrapped * bWrapped % modulus
+            && (x / y).toNumber() == aWrapped / bWrapped
+            && (x % y).toNumber() == aWrapped % bWrapped;
+    }
+    std::cout << (match ? "FixedInt<256> matches StringAsNumber" : "FixedInt<256> differs from StringAsNumber!") << std::endl;
+
+    StringAsNumber big = randomNumber(70, seed);
+    StringAsNumber step = randomNumber(60, seed);
+    FixedInt<256> fixedBig(big);
+    FixedInt<256> fixedStep(step);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < additions; i++) {
+        fixedBig = fixedBig + fixedStep;
+    }
+    double fixedTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < additions; i++) {
+        big = big + step;
+    }
+    double numberTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << additions << " 256-bit additions: FixedInt " << fixedTime << " ms, StringAsNumber " << numberTime << " ms" << std::endl;
+    std::cout << (fixedBig.toNumber() == big % modulus ? "Sums match" : "Sums differ!") << std::endl;
+}
+
+void runDecimalBenchmark() { // exact decimal sums against double, and the rounding modes
+    const int count = 1000000;
+    unsigned int seed = 23;
+    BigDecimal* amounts = new BigDecimal[count]; // prices like 123.45, with 2 digits after the point
+    double doubleSum = 0;
+    for (int i = 0; i < count; i++) {
+        seed = seed * 1103515245 + 12345;
+        long long cents = (seed >> 8) % 10000000;
+        amounts[i] = BigDecimal(StringAsNumber::fromInteger(cents), 2);
+        doubleSum += cents / 100.0;
+    }
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    BigDecimal total = BigDecimal::sum(amounts, count);
+    double accumulatorTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    BigDecimal naive;
+    for (int i = 0; i < count; i++) {
+        naive = naive + amounts[i];
+    }
+    double naiveTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Sum of " << count << " amounts: " << total.toString() << " (accumulator " << accumulatorTime
+        << " ms, total = total + x " << naiveTime << " ms)" << std::endl;
+    std::cout << (total == naive ? "Sums match" : "Sums differ!") << std::endl;
+    std::cout.precision(17);
+    std::cout << "The same sum with double: " << doubleSum << std::endl;
+    std::cout.precision(6); // the default
+    delete[] amounts;
+    amounts = nullptr;
+
+    std::cout << "1 / 3 with 30 digits: "; BigDecimal("1").divide(BigDecimal("3"), 30, RoundingMode::HALF_EVEN).printNumber();
+    const char* modeNames[7] = { "DOWN", "UP", "FLOOR", "CEILING", "HALF_UP", "HALF_DOWN", "HALF_EVEN" };
+    const RoundingMode modes[7] = { RoundingMode::DOWN, RoundingMode::UP, RoundingMode::FLOOR, RoundingMode::CEILING,
+        RoundingMode::HALF_UP, RoundingMode::HALF_DOWN, RoundingMode::HALF_EVEN };
+    const char* values[4] = { "2.5", "-2.5", "3.5", "2.51" };
+    for (int mode = 0; mode < 7; mode++) {
+        std::cout << modeNames[mode] << ":";
+        for (int i = 0; i < 4; i++) {
+            std::cout << " " << values[i] << " -> " << BigDecimal(values[i]).setScale(0, modes[mode]).toString();
+        }
+        std::cout << std::endl;
+    }
+}
+
+void runProductBenchmark(int n) { // n! with a chain of *=, and with the product tree on 1 thread and on all of them
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    StringAsNumber chain = StringAsNumber::fromInteger(1);
+    for (int i = 2; i <= n; i++) {
+        chain *= StringAsNumber::fromInteger(i);
+    }
+    double chainTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << n << "! with *= one factor at a time: " << chainTime << " ms" << std::endl;
+
+    WorkerPool serial(1);
+    WorkerPool parallel;
+    WorkerPool* pools[2] = { &serial, &parallel };
+    StringAsNumber results[2];
+    for (int i = 0; i < 2; i++) {
+        start = std::chrono::steady_clock::now();
+        results[i] = factorial(n, *pools[i]);
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << n << "! with a product tree on " << pools[i]->getThreadCount() << " thread(s): " << elapsed << " ms" << std::endl;
+    }
+    std::cout << n << "! has " << results[1].toString().size() << " digits" << std::endl;
+    std::cout << (results[0] == chain && results[1] == chain ? "Factorials match" : "Factorials differ!") << std::endl;
+}
+
+void runPowmodBenchmark() { // a 2048-bit (617 digit) modular exponentiation, the size used by RSA, done in three ways
+    unsigned int seed = 13;
+    StringAsNumber modulus = randomNumber(617, seed);
+    if (!modulus.testBit(0)) { // Montgomery needs an odd modulus
+        modulus += StringAsNumber::fromInteger(1);
+    }
+    StringAsNumber base = randomNumber(617, seed);
+    StringAsNumber exponent = randomNumber(617, seed);
+    const char* names[3] = { "Square-and-multiply with %", "Montgomery", "Barrett" };
+    StringAsNumber (*algorithms[3])(const StringAsNumber&, const StringAsNumber&, const StringAsNumber&) = {
+        powmodReference, StringAsNumber::powmod, barrettPowmod
+    };
+    StringAsNumber results[3];
+    for (int algorithm = 0; algorithm < 3; algorithm++) {
+        double elapsed = timePowmod(algorithms[algorithm], base, exponent, modulus, results[algorithm]);
+        std::cout << names[algorithm] << ": " << modulus.bitLength() << "-bit powmod in " << elapsed << " ms" << std::endl;
+    }
+    bool match = results[0] == results[1] && results[0] == results[2];
+
+    // the special cases: modulus 1, exponent 0, an even modulus, a negative base and a negative modulus
+    const char* cases[5][3] = {
+        { "123456789", "1000", "1" },
+        { "123456789", "0", "1000000007" },
+        { "123456789123456789123456789", "65537", "340282366920938463463374607431768211456" },
+        { "-123456789123456789", "12345", "1000000007" },
+        { "7", "222", "-1000000007" },
+    };
+    for (int i = 0; i < 5; i++) {
+        StringAsNumber caseBase(cases[i][0]);
+        StringAsNumber caseExponent(cases[i][1]);
+        StringAsNumber caseModulus(cases[i][2]);
+        match = match && StringAsNumber::powmod(caseBase, caseExponent, caseModulus) == powmodReference(caseBase, caseExponent, caseModulus);
+    }
+    std::cout << (match ? "Modular exponentiations match" : "Modular exponentiations differ!") << std::endl;
+}
 
 int main() {
     StringAsNumber a("-12373213123112312312312312353536546");
@@ -570,9 +2865,70 @@ int main() {
     std::cout << "a - b = "; (a - b).printNumber();
     std::cout << "a * b = "; (a * b).printNumber();
     std::cout << "a / b = "; (a / b).printNumber();
+    std::cout << "a % b = "; (a % b).printNumber();
     std::cout << "a *= (-1) = "; (a *= StringAsNumber("-1")).printNumber(); // since assignment operators return an object, we can do this
     std::cout << "a /= (-3) = "; (a /= StringAsNumber("-3")).printNumber();
     std::cout << "a += 6 = "; (a += StringAsNumber("6")).printNumber();
     std::cout << "a -= 9 = "; (a -= StringAsNumber("9")).printNumber();
+
+    // together the benchmarks take several seconds, so they only run when picked from the menu;
+    // the thresholds stay at the built-in defaults unless the user asks to measure them on this machine (option 10)
+    while (true) {
+        std::cout << "1. Benchmark allocations" << std::endl;
+        std::cout << "2. Benchmark multiplication" << std::endl;
+        std::cout << "3. Benchmark division" << std::endl;
+        std::cout << "4. Benchmark modular exponentiation" << std::endl;
+        std::cout << "5. Benchmark decimal conversion" << std::endl;
+        std::cout << "6. Benchmark FixedInt" << std::endl;
+        std::cout << "7. Benchmark BigDecimal" << std::endl;
+        std::cout << "8. Benchmark factorial" << std::endl;
+        std::cout << "9. Run all benchmarks" << std::endl;
+        std::cout << "10. Retune multiplication thresholds" << std::endl;
+        std::cout << "11. Exit" << std::endl;
+        std::cout << "Choose option: ";
+
+        int option;
+        if (!(std::cin >> option)) { // no more input (or not a number), nothing left to do
+            break;
+        }
+
+        if (option == 1 || option == 9) {
+            runAllocationBenchmark();
+        }
+        if (option == 2 || option == 9) {
+            runMultiplicationBenchmark(100000, 0);
+            runMultiplicationBenchmark(1000000, 2);
+        }
+        if (option == 3 || option == 9) {
+            runDivisionBenchmark(100000);
+        }
+        if (option == 4 || option == 9) {
+            runPowmodBenchmark();
+        }
+        if (option == 5 || option == 9) {
+            runConversionBenchmark(1000000);
+        }
+        if (option == 6 || option == 9) {
+            runFixedIntBenchmark();
+        }
+        if (option == 7 || option == 9) {
+            runDecimalBenchmark();
+        }
+        if (option == 8 || option == 9) {
+            runProductBenchmark(100000);
+        }
+        if (option == 10) {
+            std::cout << "Current thresholds: Karatsuba from " << StringAsNumber::getKaratsubaThreshold() << " limbs, Toom-3 from "
+                << StringAsNumber::getToom3Threshold() << " limbs, NTT from " << StringAsNumber::getNttThreshold() << " limbs" << std::endl;
+            tuneMultiplication();
+        }
+        else if (option == 11) {
+            std::cout << "Goodbye!" << std::endl;
+            break;
+        }
+        else if (option < 1 || option > 11) {
+            std::cout << "Invalid option!" << std::endl;
+        }
+    }
     return 0;
 }